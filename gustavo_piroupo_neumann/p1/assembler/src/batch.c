@@ -0,0 +1,207 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "lexer.h"
+#include "parser.h"
+#include "peephole.h"
+#include "sourcemap.h"
+
+// Monta muitos .asm em paralelo; cada job tem o seu lexer e o seu parser
+
+typedef struct {
+    char** inputs;
+    char** outputs;
+    int count;
+    int* failed;          // 1 se o job falhou
+    int optimize;         // -O: passada peephole em cada job
+    int executable;       // -x: grava tambem o .nex
+    int source_map;       // -g: grava tambem o mapa de fontes
+    atomic_int removed;   // Instrucoes removidas pela peephole
+    atomic_int next;      // Proximo job livre
+} Batch;
+
+static int assemble(Batch* batch, const char* input, const char* output) {
+    Lexer* lexer = lexer_init(input);
+    if (!lexer) {
+        fprintf(stderr, "Error opening input file: %s\n", input);
+        return 0;
+    }
+
+    Parser* parser = parser_init(lexer, instructions, NUM_INSTRUCTIONS);
+    int ok = parser && parser_parse(parser);
+
+    if (ok && batch->optimize) {
+        int removed = peephole_optimize(parser);
+        if (removed > 0) atomic_fetch_add(&batch->removed, removed);
+    }
+    ok = ok && parser_write_files(parser, output);
+
+    if (ok && batch->executable) {
+        char nex_filename[PATH_LENGTH];
+        executable_filename(nex_filename, output);
+        ok = parser_write_executable(parser, nex_filename);
+    }
+
+    if (ok && batch->source_map) {
+        char map_filename[PATH_LENGTH];
+        snprintf(map_filename, sizeof(map_filename), "%s.map", output);
+        ok = sourcemap_write(parser, input, map_filename);
+    }
+
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    return ok;
+}
+
+static void* worker(void* arg) {
+    Batch* batch = arg;
+
+    for (;;) {
+        int job = atomic_fetch_add(&batch->next, 1);
+        if (job >= batch->count) break;
+
+        batch->failed[job] = !assemble(batch, batch->inputs[job], batch->outputs[job]);
+    }
+
+    return NULL;
+}
+
+// x.asm -> x.mem, no diretorio de saida se houver um
+static char* output_name(const char* input, const char* directory) {
+    const char* base = input;
+    if (directory) {
+        const char* slash = strrchr(input, '/');
+        if (slash) base = slash + 1;
+    }
+
+    const char* dot = strrchr(base, '.');
+    const char* slash = strrchr(base, '/');
+    size_t length = (dot && (!slash || dot > slash)) ? (size_t)(dot - base) : strlen(base);
+
+    char* name = malloc(PATH_LENGTH);
+    if (directory) {
+        snprintf(name, PATH_LENGTH, "%s/%.*s.mem", directory, (int)length, base);
+    } else {
+        snprintf(name, PATH_LENGTH, "%.*s.mem", (int)length, base);
+    }
+    return name;
+}
+
+static void add_input(char*** inputs, int* count, int* capacity, const char* input) {
+    if (*count == *capacity) {
+        *capacity *= 2;
+        *inputs = realloc(*inputs, *capacity * sizeof(char*));
+    }
+    (*inputs)[(*count)++] = strdup(input);
+}
+
+// Acrescenta os caminhos do manifesto, um por linha
+static int read_manifest(const char* filename, char*** inputs, int* count, int* capacity) {
+    FILE* manifest = fopen(filename, "r");
+    if (!manifest) {
+        fprintf(stderr, "Error opening manifest: %s\n", filename);
+        return 0;
+    }
+
+    char line[PATH_LENGTH];
+    while (fgets(line, sizeof(line), manifest)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0') continue;
+        add_input(inputs, count, capacity, line);
+    }
+
+    fclose(manifest);
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    init_output_mode(); // Antes das threads: umask() e global ao processo
+
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char* directory = NULL;
+    int optimize = 0;
+    int executable = 0;
+    int source_map = 0;
+    int capacity = 64;
+    int count = 0;
+    char** inputs = malloc(capacity * sizeof(char*));
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            directory = argv[++i];
+        } else if (strcmp(argv[i], "-O") == 0) {
+            optimize = 1;
+        } else if (strcmp(argv[i], "-x") == 0) {
+            executable = 1;
+        } else if (strcmp(argv[i], "-g") == 0) {
+            source_map = 1;
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            if (!read_manifest(argv[++i], &inputs, &count, &capacity)) {
+                return 1;
+            }
+        } else {
+            add_input(&inputs, &count, &capacity, argv[i]);
+        }
+    }
+
+    if (count == 0) {
+        fprintf(stderr, "Usage: %s [-j threads] [-o output_dir] [-O] [-x] [-g] [-l manifest] [file.asm ...]\n", argv[0]);
+        return 1;
+    }
+
+    if (threads < 1) threads = 1;
+    if (threads > count) threads = count;
+
+    Batch batch;
+    batch.inputs = inputs;
+    batch.outputs = malloc(count * sizeof(char*));
+    batch.count = count;
+    batch.failed = calloc(count, sizeof(int));
+    batch.optimize = optimize;
+    batch.executable = executable;
+    batch.source_map = source_map;
+    atomic_init(&batch.removed, 0);
+    atomic_init(&batch.next, 0);
+
+    for (int i = 0; i < count; i++) {
+        batch.outputs[i] = output_name(inputs[i], directory);
+    }
+
+    pthread_t* pool = malloc(threads * sizeof(pthread_t));
+    for (int i = 0; i < threads; i++) {
+        pthread_create(&pool[i], NULL, worker, &batch);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(pool[i], NULL);
+    }
+
+    // As mensagens do parser nao tem o nome do arquivo: lista os que falharam
+    int failed = 0;
+    for (int i = 0; i < count; i++) {
+        if (batch.failed[i]) {
+            fprintf(stderr, "Error: %s: assembly failed\n", inputs[i]);
+            failed++;
+        }
+    }
+
+    printf("%d files, %d assembled, %d failed, %d threads\n", count, count - failed, failed, threads);
+    if (optimize) {
+        printf("peephole: %d instructions removed\n", atomic_load(&batch.removed));
+    }
+
+    for (int i = 0; i < count; i++) {
+        free(inputs[i]);
+        free(batch.outputs[i]);
+    }
+    free(inputs);
+    free(batch.outputs);
+    free(batch.failed);
+    free(pool);
+
+    return failed ? 1 : 0;
+}
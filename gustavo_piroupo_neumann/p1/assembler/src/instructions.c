@@ -0,0 +1,21 @@
+#include "parser.h"
+
+// Mineumonicos, na posicao dada pelo hash perfeito
+#define INSTRUCTION(a, b, c, name, opcode, operands) \
+    [MNEMONIC_HASH(a, b, c)] = {name, opcode, operands}
+
+Instruction instructions[MNEMONIC_SLOTS] = {
+    INSTRUCTION('N', 'O', 'P', "NOP", 0x0000, 1),
+    INSTRUCTION('S', 'T', 'A', "STA", 0x0010, 1),
+    INSTRUCTION('L', 'D', 'A', "LDA", 0x0020, 1),
+    INSTRUCTION('A', 'D', 'D', "ADD", 0x0030, 1),
+    INSTRUCTION('O', 'R', 0,   "OR",  0x0040, 1),
+    INSTRUCTION('A', 'N', 'D', "AND", 0x0050, 1),
+    INSTRUCTION('N', 'O', 'T', "NOT", 0x0060, 0),
+    INSTRUCTION('J', 'M', 'P', "JMP", 0x0080, 1),
+    INSTRUCTION('J', 'N', 0,   "JN",  0x0090, 1),
+    INSTRUCTION('J', 'Z', 0,   "JZ",  0x00A0, 1),
+    INSTRUCTION('H', 'L', 'T', "HLT", 0x00F0, 0)
+};
+
+const int NUM_INSTRUCTIONS = MNEMONIC_SLOTS;
@@ -1,23 +1,55 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "lexer.h"
 
-Lexer* lexer_init(FILE* input) {
+// Mapeia o arquivo inteiro; os tokens apontam para dentro dele
+Lexer* lexer_init(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    const char* source = NULL;
+    if (info.st_size > 0) {
+        source = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (source == MAP_FAILED) {
+            close(fd);
+            return NULL;
+        }
+        madvise((void*)source, info.st_size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
     Lexer* lexer = (Lexer*)malloc(sizeof(Lexer));
-    if (!lexer) return NULL;
-    
-    lexer->input_file = input;
-    lexer->line[0] = '\0';
-    lexer->line_ptr = lexer->line;
+    if (!lexer) {
+        if (source) munmap((void*)source, info.st_size);
+        return NULL;
+    }
+
+    lexer->source = source;
+    lexer->size = info.st_size;
+    lexer->cursor = source;
+    lexer->end = source + info.st_size;
     lexer->line_number = 0;
-    lexer->in_comment = 0;
-    
+    lexer->at_line_start = 1;
+
     return lexer;
 }
 
 void lexer_destroy(Lexer* lexer) {
     if (lexer) {
+        if (lexer->source) {
+            munmap((void*)lexer->source, lexer->size);
+        }
         free(lexer);
     }
 }
@@ -27,146 +59,142 @@ int is_delimiter(char c) {
     return (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ';');
 }
 
-// Verifica se é comentario
-int is_comment(const char* line) {
-    // Pula espacos em branco
-    while (*line && (*line == ' ' || *line == '\t')) {
-        line++;
-    }
-    
-    // Se a linha começa com ;
-    return  (*line == ';');
+int token_equals(Token token, const char* text) {
+    return (int)strlen(text) == token.length && memcmp(token.value, text, token.length) == 0;
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
 }
 
 // Verifica se é hexadecimal
-int is_hex(const char* str) {
+int is_hex(const char* str, int length) {
+    int i = 0;
 
-    if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
-        str += 2; 
+    if (length >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+        i = 2;
     }
-    
-    while (*str) {
-        if (!((*str >= '0' && *str <= '9') || 
-              (*str >= 'a' && *str <= 'f') || 
-              (*str >= 'A' && *str <= 'F'))) {
-            return 0; 
+
+    for (; i < length; i++) {
+        if (hex_digit(str[i]) < 0) {
+            return 0;
         }
-        str++;
     }
-    
-    return 1; 
+
+    return 1;
 }
 
-int hex_to_int(const char* hex) {
+int hex_to_int(const char* hex, int length) {
     int result = 0;
-    while (*hex) {
-        result *= 16;
-        if (*hex >= '0' && *hex <= '9') {
-            result += *hex - '0';
-        } else if (*hex >= 'A' && *hex <= 'F') {
-            result += *hex - 'A' + 10;
-        } else if (*hex >= 'a' && *hex <= 'f') {
-            result += *hex - 'a' + 10;
-        }
-        hex++;
+    for (int i = 0; i < length && hex_digit(hex[i]) >= 0; i++) {
+        result = result * 16 + hex_digit(hex[i]);
     }
     return result;
 }
 
-// Converte string pra numero
-int parse_number(const char* str) {
-    if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
-        return strtol(str + 2, NULL, 16);
+// Converte pra numero: 0x.. e digitos hexadecimais sao hexadecimais, o
+// resto e decimal ate o primeiro caractere invalido
+int parse_number(const char* str, int length) {
+    if (length >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+        return hex_to_int(str + 2, length - 2);
     }
-    
-    if (is_hex(str)) {
-        return hex_to_int(str);
+
+    if (is_hex(str, length)) {
+        return hex_to_int(str, length);
     }
-    
-    return atoi(str);
+
+    int i = 0;
+    int sign = 1;
+    int result = 0;
+    if (i < length && (str[i] == '-' || str[i] == '+')) {
+        sign = (str[i] == '-') ? -1 : 1;
+        i++;
+    }
+    for (; i < length && isdigit((unsigned char)str[i]); i++) {
+        result = result * 10 + (str[i] - '0');
+    }
+    return sign * result;
 }
 
-// Pega o proximo token
-Token* lexer_next_token(Lexer* lexer) {
-    Token* token = (Token*)malloc(sizeof(Token));
-    if (!token) return NULL;
-    
-    token->type = TOKEN_NONE;
-    token->value = NULL;
-    token->line_number = lexer->line_number;
-    
-    // Se a linha acabar le uma nova
-    if (*(lexer->line_ptr) == '\0') {
-        if (fgets(lexer->line, MAX_LINE_LENGTH, lexer->input_file) == NULL) {
-            token->type = TOKEN_EOF;
+// Se a linha so tem espacos antes do ;
+static int is_comment_line(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+    return p < end && *p == ';';
+}
+
+static const char* skip_line(const char* p, const char* end) {
+    const char* newline = memchr(p, '\n', end - p);
+    return newline ? newline + 1 : end;
+}
+
+// Pega o proximo token. Linhas so de comentario nao geram tokens; o fim de
+// uma linha com espacos ou comentario depois do ultimo token gera TOKEN_EOL.
+Token lexer_next_token(Lexer* lexer) {
+    Token token = {TOKEN_NONE, NULL, 0, lexer->line_number};
+    const char* p = lexer->cursor;
+    const char* end = lexer->end;
+
+    // Comeca uma linha nova, pulando as de comentario
+    while (lexer->at_line_start) {
+        if (p == end) {
+            lexer->cursor = p;
+            token.type = TOKEN_EOF;
             return token;
         }
-        
-        lexer->line_ptr = lexer->line;
+
         lexer->line_number++;
-        
-        // Pula comentarios
-        if (is_comment(lexer->line)) {
-            free(token);
-            return lexer_next_token(lexer);
+        if (is_comment_line(p, end)) {
+            p = skip_line(p, end);
+        } else {
+            lexer->at_line_start = 0;
         }
-        
-        token->line_number = lexer->line_number;
     }
-    
+    token.line_number = lexer->line_number;
+
     // Pula delimitadores
-    while (*(lexer->line_ptr) && is_delimiter(*(lexer->line_ptr))) {
-        if (*(lexer->line_ptr) == ';') {
-            *(lexer->line_ptr) = '\0';
-            token->type = TOKEN_EOL;
-            return token;
-        }
-        (lexer->line_ptr)++;
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
     }
-    
-    // Verifica fim da linha
-    if (*(lexer->line_ptr) == '\0') {
-        token->type = TOKEN_EOL;
+
+    // Fim da linha ou comentario no fim dela
+    if (p == end || *p == '\n' || *p == ';') {
+        lexer->cursor = skip_line(p, end);
+        lexer->at_line_start = 1;
+        token.type = TOKEN_EOL;
         return token;
     }
-    
+
     // Comeco e fim do token
-    char* token_start = lexer->line_ptr;
-    
-    while (*(lexer->line_ptr) && !is_delimiter(*(lexer->line_ptr))) {
-        (lexer->line_ptr)++;
-    }
-    
-    char saved_char = *(lexer->line_ptr);
-    if (*(lexer->line_ptr)) {
-        *(lexer->line_ptr) = '\0';
-        (lexer->line_ptr)++;
-    }
-    
+    const char* token_start = p;
+    while (p < end && !is_delimiter(*p)) {
+        p++;
+    }
+
+    token.value = token_start;
+    token.length = (int)(p - token_start);
+
+    // O delimitador logo depois do token e consumido junto
+    if (p < end && *p != ';') {
+        if (*p == '\n') {
+            lexer->at_line_start = 1;
+        }
+        p++;
+    }
+    lexer->cursor = p;
+
     // Determina o tipo do token
     if (token_start[0] == '.') {
-        token->type = TOKEN_DIRECTIVE;
-    } else if (isdigit(token_start[0]) || 
-              (token_start[0] == '0' && (token_start[1] == 'x' || token_start[1] == 'X'))) {
-        token->type = TOKEN_NUMBER;
+        token.type = TOKEN_DIRECTIVE;
+    } else if (isdigit((unsigned char)token_start[0])) {
+        token.type = TOKEN_NUMBER;
     } else {
-        token->type = TOKEN_MNEMONIC;
+        token.type = TOKEN_MNEMONIC;
     }
-    
-    token->value = strdup(token_start);
 
-    if (saved_char != '\0') {
-        *(lexer->line_ptr - 1) = saved_char;
-    }
-    
     return token;
 }
-
-void token_destroy(Token* token) {
-    if (token) {
-        if (token->value) {
-            free(token->value);
-        }
-        free(token);
-    }
-}
\ No newline at end of file
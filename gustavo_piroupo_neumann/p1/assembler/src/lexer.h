@@ -1,9 +1,7 @@
 #ifndef LEXER_H
 #define LEXER_H
 
-#include <stdio.h>
-
-#define MAX_LINE_LENGTH 256
+#include <stddef.h>
 
 typedef enum {
     TOKEN_NONE,
@@ -14,29 +12,32 @@ typedef enum {
     TOKEN_EOF
 } TokenType;
 
+// O valor e um pedaco do arquivo mapeado, sem terminador
 typedef struct {
     TokenType type;
-    char* value;
+    const char* value;
+    int length;
     int line_number;
 } Token;
 
 typedef struct {
-    FILE* input_file;
-    char line[MAX_LINE_LENGTH];
-    char* line_ptr;
+    const char* source;   // Arquivo mapeado
+    size_t size;
+    const char* cursor;
+    const char* end;
     int line_number;
-    int in_comment;
+    int at_line_start;
 } Lexer;
 
-Lexer* lexer_init(FILE* input);
+Lexer* lexer_init(const char* filename);
 void lexer_destroy(Lexer* lexer);
-Token* lexer_next_token(Lexer* lexer);
-void token_destroy(Token* token);
+Token lexer_next_token(Lexer* lexer);
+
+int token_equals(Token token, const char* text);
 
 int is_delimiter(char c);
-int is_comment(const char* line);
-int is_hex(const char* str);
-int hex_to_int(const char* hex);
-int parse_number(const char* str);
+int is_hex(const char* str, int length);
+int hex_to_int(const char* hex, int length);
+int parse_number(const char* str, int length);
 
-#endif // LEXER_H
\ No newline at end of file
+#endif // LEXER_H
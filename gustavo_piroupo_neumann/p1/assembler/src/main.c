@@ -1,61 +1,91 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "lexer.h"
 #include "parser.h"
-
-// Mineumonicos
-Instruction instructions[] = {
-    {"NOP", 0x0000},
-    {"STA", 0x0010},
-    {"LDA", 0x0020},
-    {"ADD", 0x0030},
-    {"OR",  0x0040},
-    {"AND", 0x0050},
-    {"NOT", 0x0060},
-    {"JMP", 0x0080},
-    {"JN",  0x0090},
-    {"JZ",  0x00A0},
-    {"HLT", 0x00F0}
-};
-
-const int NUM_INSTRUCTIONS = sizeof(instructions) / sizeof(Instruction);
+#include "peephole.h"
+#include "sourcemap.h"
 
 int main(int argc, char* argv[]) {
-    FILE* input_file;
-    
-    if (argc != 3) {
-        fprintf(stderr, "Usage: %s input_file output_file\n", argv[0]);
+    // -O liga a otimizacao peephole; -x grava tambem o .nex e -g o mapa
+    // de fontes
+    int optimize = 0;
+    int executable = 0;
+    int source_map = 0;
+    int i = 1;
+    for (; i < argc - 2; i++) {
+        if (strcmp(argv[i], "-O") == 0) {
+            optimize = 1;
+        } else if (strcmp(argv[i], "-x") == 0) {
+            executable = 1;
+        } else if (strcmp(argv[i], "-g") == 0) {
+            source_map = 1;
+        } else {
+            break;
+        }
+    }
+    if (argc < 3 || i != argc - 2) {
+        fprintf(stderr, "Usage: %s [-O] [-x] [-g] input_file output_file\n", argv[0]);
         return 1;
     }
+    const char* input = argv[argc - 2];
+    const char* output = argv[argc - 1];
     
-    input_file = fopen(argv[1], "r");
-    if (!input_file) {
-        fprintf(stderr, "Error opening input file: %s\n", argv[1]);
+    Lexer* lexer = lexer_init(input);
+    if (!lexer) {
+        fprintf(stderr, "Error opening input file: %s\n", input);
         return 1;
     }
-    
-    Lexer* lexer = lexer_init(input_file);
+
     Parser* parser = parser_init(lexer, instructions, NUM_INSTRUCTIONS);
     
     if (!parser_parse(parser)) {
         fprintf(stderr, "Error parsing input file.\n");
         parser_destroy(parser);
         lexer_destroy(lexer);
-        fclose(input_file);
         return 1;
     }
+
+    if (optimize) {
+        int removed = peephole_optimize(parser);
+        if (removed == PEEPHOLE_SKIPPED) {
+            printf("Peephole: skipped, code cannot be moved safely\n");
+        } else {
+            printf("Peephole: %d instructions removed\n", removed);
+        }
+    }
     
-    if (!parser_write_output(parser, argv[2])) {
+    if (!parser_write_output(parser, output)) {
         fprintf(stderr, "Error writing output file.\n");
         parser_destroy(parser);
         lexer_destroy(lexer);
-        fclose(input_file);
         return 1;
     }
+
+    if (executable) {
+        char nex_filename[PATH_LENGTH];
+        executable_filename(nex_filename, output);
+        if (!parser_write_executable(parser, nex_filename)) {
+            parser_destroy(parser);
+            lexer_destroy(lexer);
+            return 1;
+        }
+        printf("Executable file generated: %s\n", nex_filename);
+    }
+
+    if (source_map) {
+        char map_filename[PATH_LENGTH];
+        snprintf(map_filename, sizeof(map_filename), "%s.map", output);
+        if (!sourcemap_write(parser, input, map_filename)) {
+            parser_destroy(parser);
+            lexer_destroy(lexer);
+            return 1;
+        }
+        printf("Source map generated: %s\n", map_filename);
+    }
     
     parser_destroy(parser);
     lexer_destroy(lexer);
-    fclose(input_file);
     
     return 0;
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "parser.h"
 
 Parser* parser_init(Lexer* lexer, const Instruction* instructions, int num_instructions) {
@@ -13,6 +15,9 @@ Parser* parser_init(Lexer* lexer, const Instruction* instructions, int num_instr
     parser->in_data_section = 0;
     parser->instructions = instructions;
     parser->num_instructions = num_instructions;
+    parser->code_count = 0;
+    parser->data_max_address = -1;
+    memset(parser->is_data, 0, sizeof(parser->is_data));
     
     return parser;
 }
@@ -23,37 +28,40 @@ void parser_destroy(Parser* parser) {
     }
 }
 
-// Procura a instrucao pelo mineumonico
-int find_instruction(const Instruction* instructions, int num_instructions, const char* mnemonic) {
-    for (int i = 0; i < num_instructions; i++) {
-        if (strcmp(instructions[i].mnemonic, mnemonic) == 0) {
-            return i;
-        }
+// Procura a instrucao pelo mineumonico: um hash e uma comparacao
+int find_instruction(const Instruction* instructions, int num_instructions, Token mnemonic) {
+    if (mnemonic.length < 2 || mnemonic.length > 3) {
+        return -1;
+    }
+
+    const unsigned char* m = (const unsigned char*)mnemonic.value;
+    int i = MNEMONIC_HASH(m[0], m[1], mnemonic.length == 3 ? m[2] : 0);
+
+    if (i >= num_instructions || !instructions[i].mnemonic ||
+        !token_equals(mnemonic, instructions[i].mnemonic)) {
+        return -1;
     }
-    return -1;
+    return i;
 }
 
 // Parse e assemble
 int parser_parse(Parser* parser) {
-    Token* token;
+    Token token;
     
-    while ((token = lexer_next_token(parser->lexer))->type != TOKEN_EOF) {
+    while ((token = lexer_next_token(parser->lexer)).type != TOKEN_EOF) {
         // End of line
-        if (token->type == TOKEN_EOL) {
-            token_destroy(token);
+        if (token.type == TOKEN_EOL) {
             continue;
         }
         
         // Encontra .DATA ou .CODE
-        if (token->type == TOKEN_DIRECTIVE) {
-            if (strcmp(token->value, ".DATA") == 0) {
+        if (token.type == TOKEN_DIRECTIVE) {
+            if (token_equals(token, ".DATA")) {
                 parser->in_data_section = 1;
-                token_destroy(token);
                 continue;
-            } else if (strcmp(token->value, ".CODE") == 0) {
+            } else if (token_equals(token, ".CODE")) {
                 parser->in_data_section = 0;
                 parser->code_address = 0;  
-                token_destroy(token);
                 continue;
             }
         }
@@ -61,72 +69,78 @@ int parser_parse(Parser* parser) {
         // Processa
         if (parser->in_data_section) {
             // .DATA
-            if (token->type != TOKEN_NUMBER) {
+            if (token.type != TOKEN_NUMBER) {
                 fprintf(stderr, "Error: Expected address number in DATA section at line %d\n", 
-                        token->line_number);
-                token_destroy(token);
+                        token.line_number);
                 return 0;
             }
             
-            int address = parse_number(token->value);
-            token_destroy(token);
+            int address = parse_number(token.value, token.length);
             
             token = lexer_next_token(parser->lexer);
-            if (token->type != TOKEN_NUMBER) {
+            if (token.type != TOKEN_NUMBER) {
                 fprintf(stderr, "Error: Expected value after address at line %d\n", 
-                        token->line_number);
-                token_destroy(token);
+                        token.line_number);
                 return 0;
             }
             
-            int value = parse_number(token->value);
-            token_destroy(token);
+            int value = parse_number(token.value, token.length);
             
             // Escreve o valor no endereco
             parser->memory[address] = value;
+            if (address >= 0 && address < MEMORY_SIZE) {
+                parser->is_data[address] = 1;
+            }
             
             if (address > parser->max_address) {
                 parser->max_address = address;
             }
+            if (address > parser->data_max_address) {
+                parser->data_max_address = address;
+            }
         } else {
             // .CODE
-            if (token->type != TOKEN_MNEMONIC) {
+            if (token.type != TOKEN_MNEMONIC) {
                 fprintf(stderr, "Error: Expected mnemonic in CODE section at line %d\n", 
-                        token->line_number);
-                token_destroy(token);
+                        token.line_number);
                 return 0;
             }
             
-            int instr_index = find_instruction(parser->instructions, parser->num_instructions, token->value);
+            int instr_index = find_instruction(parser->instructions, parser->num_instructions, token);
             if (instr_index == -1) {
-                fprintf(stderr, "Error: Unknown mnemonic '%s' at line %d\n", 
-                        token->value, token->line_number);
-                token_destroy(token);
+                fprintf(stderr, "Error: Unknown mnemonic '%.*s' at line %d\n", 
+                        token.length, token.value, token.line_number);
                 return 0;
             }
             
             parser->memory[parser->code_address] = parser->instructions[instr_index].opcode;
+
+            ParsedInstruction* parsed = NULL;
+            if (parser->code_count < MEMORY_SIZE) {
+                parsed = &parser->code[parser->code_count++];
+                parsed->address = parser->code_address;
+                parsed->opcode = parser->instructions[instr_index].opcode;
+                parsed->operand = 0;
+                parsed->length = 1;
+                parsed->line = token.line_number;
+            }
             
-            // Verifica se precisa de operand
-            if (strcmp(token->value, "HLT") != 0 && 
-                strcmp(token->value, "NOT") != 0) {
-                // Instrucao com operando
-                token_destroy(token);
-                
+            // Instrucao com operando
+            if (parser->instructions[instr_index].operands) {
                 token = lexer_next_token(parser->lexer);
-                if (token->type != TOKEN_NUMBER) {
+                if (token.type != TOKEN_NUMBER) {
                     fprintf(stderr, "Error: Expected operand for instruction at line %d\n", 
-                            token->line_number);
-                    token_destroy(token);
+                            token.line_number);
                     return 0;
                 }
                 
-                int operand = parse_number(token->value);
+                int operand = parse_number(token.value, token.length);
                 parser->code_address++;
                 parser->memory[parser->code_address] = operand;
-            } else {
-                // Nao precisa de operando para NOT ou HLT
-                token_destroy(token);
+                if (parsed) {
+                    parsed->operand = operand;
+                    parsed->length = 2;
+                }
             }
             
             parser->code_address++;
@@ -137,87 +151,251 @@ int parser_parse(Parser* parser) {
         }
     }
     
-    token_destroy(token);
     return 1;
 }
 
-// Montagem
-int parser_write_output(Parser* parser, const char* output_filename) {
-    FILE* output_file;
-    
-    unsigned short temp_memory[MEMORY_SIZE] = {0};
-    for (int i = 0; i <= parser->max_address; i++) {
-        temp_memory[i] = parser->memory[i];
-    }
-    
-    parser->memory[0] = 0x4e03;  
-    parser->memory[1] = 0x5244;  
-    
-    for (int i = 0; i <= parser->max_address; i++) {
-        parser->memory[i + 2] = temp_memory[i];
+// Cabecalho do .mem, antes da imagem
+static const unsigned short file_header[FILE_HEADER_WORDS] = {0x4e03, 0x5244};
+
+// Palavra i do arquivo: cabecalho, imagem e zeros depois dela
+static unsigned short file_word(const Parser* parser, int i) {
+    if (i < FILE_HEADER_WORDS) return file_header[i];
+    i -= FILE_HEADER_WORDS;
+    return i <= parser->max_address ? parser->memory[i] : 0;
+}
+
+static char* put_octal7(char* p, unsigned value) {
+    for (int i = 6; i >= 0; i--) {
+        p[i] = '0' + (value & 7);
+        value >>= 3;
     }
-    
-    parser->max_address += 2;
-    
-    output_file = fopen(output_filename, "wb");
-    if (!output_file) {
-        fprintf(stderr, "Error opening output file: %s\n", output_filename);
+    return p + 7;
+}
+
+static char* put_hex4(char* p, unsigned short value) {
+    static const char digits[] = "0123456789abcdef";
+    p[0] = digits[(value >> 12) & 0xF];
+    p[1] = digits[(value >> 8) & 0xF];
+    p[2] = digits[(value >> 4) & 0xF];
+    p[3] = digits[value & 0xF];
+    return p + 4;
+}
+
+// Modo dos arquivos novos: 0666 menos a umask, lida uma vez
+static mode_t new_file_mode = (mode_t)-1;
+
+// umask() so pode ser lida trocando-a; chamar antes de criar threads
+void init_output_mode(void) {
+    mode_t mask = umask(0);
+    umask(mask);
+    new_file_mode = 0666 & ~mask;
+}
+
+// Grava prefix e data em um temporario no mesmo diretorio e renomeia, para
+// que o arquivo nunca apareca pela metade. O resultado fica com o modo do
+// arquivo substituido ou, se ele nao existe, com o modo padrao da umask.
+int write_atomically(const char* filename, const void* data, size_t size,
+                     const void* prefix, size_t prefix_size) {
+    char temporary[PATH_LENGTH + 8];
+    snprintf(temporary, sizeof(temporary), "%s.XXXXXX", filename);
+
+    int fd = mkstemp(temporary);
+    if (fd < 0) {
         return 0;
     }
+    struct stat existing;
+    if (stat(filename, &existing) == 0) {
+        fchmod(fd, existing.st_mode & 07777);
+    } else {
+        if (new_file_mode == (mode_t)-1) init_output_mode();
+        fchmod(fd, new_file_mode);
+    }
 
-    fwrite(parser->memory, 2, parser->max_address + 1, output_file);
-    fclose(output_file);
+    FILE* file = fdopen(fd, "wb");
+    if (!file) {
+        close(fd);
+        unlink(temporary);
+        return 0;
+    }
 
-    char dump_filename[256];
-    sprintf(dump_filename, "%s.dump", output_filename);
-    FILE* dump_file = fopen(dump_filename, "w");
-    if (!dump_file) {
-        fprintf(stderr, "Error creating dump file: %s\n", dump_filename);
+    int ok = fwrite(prefix, 1, prefix_size, file) == prefix_size &&
+             fwrite(data, 1, size, file) == size;
+    if (fclose(file) != 0) {
+        ok = 0;
+    }
+    if (!ok || rename(temporary, filename) != 0) {
+        unlink(temporary);
         return 0;
     }
+    return 1;
+}
+
+// Dump no formato do od: linhas de 4 palavras com o offset em octal, e
+// as linhas de zeros do fim trocadas por "*". Uma passada, em um buffer.
+static int write_dump(const Parser* parser, const char* dump_filename) {
+    int last_word = parser->max_address + FILE_HEADER_WORDS;
+    int max_address_rounded = (last_word + 3) & ~3;
 
-    int max_address_rounded = (parser->max_address + 3) & ~3;
-    
     if (max_address_rounded < 128) {
         max_address_rounded = 128;
     }
-    
 
-    for (int i = 0; i <= max_address_rounded; i += 4) {
+    // Ultima palavra nao nula, para saber onde comecam os zeros do fim
+    int last_non_zero = -1;
+    for (int i = last_word; i >= 0; i--) {
+        if (file_word(parser, i) != 0) {
+            last_non_zero = i;
+            break;
+        }
+    }
 
-        fprintf(dump_file, "%07o", i * 2); 
-        
+    // Offset, 4 palavras e '\n' por linha, mais "*\n" e o offset final
+    size_t size = (size_t)(max_address_rounded / 4 + 1) * (7 + 4 * 5 + 1) + 2 + 8;
+    char* buffer = (char*)malloc(size);
+    if (!buffer) {
+        fprintf(stderr, "Error: out of memory\n");
+        return 0;
+    }
+    char* p = buffer;
+
+    for (int i = 0; i <= max_address_rounded; i += 4) {
+        p = put_octal7(p, i * 2);
         for (int j = 0; j < 4 && i + j <= max_address_rounded; j++) {
-            fprintf(dump_file, " %04x", parser->memory[i + j]);
+            *p++ = ' ';
+            p = put_hex4(p, file_word(parser, i + j));
         }
-        
-        fprintf(dump_file, "\n");
-        
-        int found_non_zero = 0;
-        int k;
-        for (k = i + 4; k <= max_address_rounded; k += 4) {
-            for (int j = 0; j < 4 && k + j <= max_address_rounded; j++) {
-                if (parser->memory[k + j] != 0) {
-                    found_non_zero = 1;
-                    break;
-                }
-            }
-            if (found_non_zero) break;
+        *p++ = '\n';
+
+        if (last_non_zero < i + 4 && i + 4 <= max_address_rounded) {
+            *p++ = '*';
+            *p++ = '\n';
+            break;
         }
-        
-        if (!found_non_zero && i + 4 <= max_address_rounded) {
-            fprintf(dump_file, "*\n");
-            i = k - 4; 
+    }
+
+    p = put_octal7(p, (max_address_rounded + 1) * 2);
+    *p++ = '\n';
+
+    int ok = write_atomically(dump_filename, buffer, p - buffer, NULL, 0);
+    if (!ok) {
+        fprintf(stderr, "Error creating dump file: %s\n", dump_filename);
+    }
+    free(buffer);
+    return ok;
+}
+
+// Grava o .mem e o .dump, sem mensagens de sucesso
+int parser_write_files(const Parser* parser, const char* output_filename) {
+    if (!write_atomically(output_filename, parser->memory, 2 * (parser->max_address + 1),
+                          file_header, sizeof(file_header))) {
+        fprintf(stderr, "Error opening output file: %s\n", output_filename);
+        return 0;
+    }
+
+    char dump_filename[PATH_LENGTH];
+    snprintf(dump_filename, sizeof(dump_filename), "%s.dump", output_filename);
+    return write_dump(parser, dump_filename);
+}
+
+static const unsigned char nex_header[4] = {'N', 'E', 'X', 0x02};
+
+static int is_jump(unsigned short opcode) {
+    return opcode == 0x80 || opcode == 0x90 || opcode == 0xA0;
+}
+
+// Grava o .nex. As instrucoes sao as do .CODE que continuam na imagem
+// final (uma secao .DATA ou outro .CODE pode ter escrito por cima); os
+// blocos comecam na primeira instrucao, nos destinos de desvio e depois
+// de desvios e HLT.
+int parser_write_executable(const Parser* parser, const char* nex_filename) {
+    const ParsedInstruction* at[NEX_ADDRESSES] = {NULL};
+    unsigned char leader[NEX_ADDRESSES] = {0};
+
+    for (int i = 0; i < parser->code_count; i++) {
+        const ParsedInstruction* instr = &parser->code[i];
+        if (instr->address < NEX_ADDRESSES) {
+            at[instr->address] = instr;
         }
     }
-    
-    fprintf(dump_file, "%07o\n", (max_address_rounded + 1) * 2);
-    
-    fclose(dump_file);
-    
+
+    int first = 1;
+    for (int a = 0; a < NEX_ADDRESSES; a++) {
+        const ParsedInstruction* instr = at[a];
+        if (!instr) continue;
+
+        if (parser->memory[a] != instr->opcode ||
+            (instr->length == 2 && (a + 1 >= NEX_ADDRESSES || parser->memory[a + 1] != instr->operand))) {
+            at[a] = NULL;
+            continue;
+        }
+
+        if (first) leader[a] = 1;
+        first = 0;
+        if (is_jump(instr->opcode)) {
+            leader[instr->operand & 0xFF] = 1;  // O executor usa o byte baixo
+        }
+        if ((is_jump(instr->opcode) || instr->opcode == 0xF0) && a + instr->length < NEX_ADDRESSES) {
+            leader[a + instr->length] = 1;
+        }
+    }
+
+    size_t size = 2 * NEX_ADDRESSES + 2 + NEX_ADDRESSES * NEX_RECORD_SIZE;
+    unsigned char* buffer = (unsigned char*)calloc(1, size);
+    if (!buffer) {
+        fprintf(stderr, "Error: out of memory\n");
+        return 0;
+    }
+    unsigned char* p = buffer;
+
+    for (int a = 0; a < NEX_ADDRESSES; a++) {
+        unsigned short word = a <= parser->max_address ? parser->memory[a] : 0;
+        *p++ = word & 0xFF;
+        *p++ = word >> 8;
+    }
+
+    unsigned char* count = p;
+    int records = 0;
+    p += 2;
+
+    for (int a = 0; a < NEX_ADDRESSES; a++) {
+        const ParsedInstruction* instr = at[a];
+        if (!instr) continue;
+
+        *p++ = a;
+        *p++ = instr->opcode;
+        *p++ = instr->length == 2 ? instr->operand : 0;
+        *p++ = (instr->length == 2 ? NEX_OPERAND : 0) | (leader[a] ? NEX_LEADER : 0);
+        records++;
+    }
+    count[0] = records & 0xFF;
+    count[1] = records >> 8;
+
+    int ok = write_atomically(nex_filename, buffer, p - buffer, nex_header, sizeof(nex_header));
+    if (!ok) {
+        fprintf(stderr, "Error creating executable file: %s\n", nex_filename);
+    }
+    free(buffer);
+    return ok;
+}
+
+// x.mem -> x.nex; outros nomes ganham .nex no fim
+void executable_filename(char* nex_filename, const char* output_filename) {
+    size_t length = strlen(output_filename);
+    if (length > 4 && strcmp(output_filename + length - 4, ".mem") == 0) {
+        length -= 4;
+    }
+    snprintf(nex_filename, PATH_LENGTH, "%.*s.nex", (int)length, output_filename);
+}
+
+// Montagem
+int parser_write_output(Parser* parser, const char* output_filename) {
+    if (!parser_write_files(parser, output_filename)) {
+        return 0;
+    }
+
     printf("Assembly completed successfully.\n");
     printf("Binary file generated: %s\n", output_filename);
-    printf("Dump file generated: %s\n", dump_filename);
+    printf("Dump file generated: %s.dump\n", output_filename);
     
     return 1;
-}
\ No newline at end of file
+}
@@ -5,12 +5,37 @@
 #include "lexer.h"
 
 #define MEMORY_SIZE 512 
+#define FILE_HEADER_WORDS 2
+#define PATH_LENGTH 4096
+
+// .nex: executavel pre-decodificado lido pelo executor. Cabecalho, as 256
+// palavras da imagem, numero de instrucoes (16 bits) e um registro de
+// NEX_RECORD_SIZE bytes por instrucao.
+#define NEX_ADDRESSES 256
+#define NEX_RECORD_SIZE 4
+#define NEX_OPERAND 0x01    // Instrucao com operando
+#define NEX_LEADER 0x02     // Comeco de bloco basico
+
+// Hash perfeito dos mnemonicos (2 ou 3 letras, c = 0 nos de 2), calculado
+// em tempo de compilacao para montar a tabela de instrucoes
+#define MNEMONIC_SLOTS 16
+#define MNEMONIC_HASH(a, b, c) ((((a) * 6) + ((b) * 9) + (c)) & (MNEMONIC_SLOTS - 1))
 
 typedef struct {
-    char* mnemonic;
+    char* mnemonic;         // NULL nas posicoes vazias da tabela
     unsigned short opcode; 
+    int operands;           // 1 se o mnemonico e seguido de um endereco
 } Instruction;
 
+// Instrucao montada na secao .CODE, para as passadas sobre o codigo
+typedef struct {
+    int address;
+    unsigned short opcode;
+    unsigned short operand;
+    int length;             // Palavras: 1 ou 2
+    int line;               // Linha do fonte, para o mapa de fontes
+} ParsedInstruction;
+
 typedef struct {
     Lexer* lexer;
     unsigned short memory[MEMORY_SIZE];
@@ -19,13 +44,27 @@ typedef struct {
     int in_data_section;
     const Instruction* instructions;
     int num_instructions;
+    ParsedInstruction code[MEMORY_SIZE]; // Instrucoes na ordem do fonte
+    int code_count;
+    int data_max_address;   // Maior endereco da secao .DATA, -1 se nenhum
+    unsigned char is_data[MEMORY_SIZE];  // Enderecos escritos pela secao .DATA
 } Parser;
 
+// Tabela de instrucoes (instructions.c), indexada por MNEMONIC_HASH
+extern Instruction instructions[MNEMONIC_SLOTS];
+extern const int NUM_INSTRUCTIONS;
+
 Parser* parser_init(Lexer* lexer, const Instruction* instructions, int num_instructions);
 void parser_destroy(Parser* parser);
 int parser_parse(Parser* parser);
 int parser_write_output(Parser* parser, const char* output_filename);
+int parser_write_files(const Parser* parser, const char* output_filename);
+int parser_write_executable(const Parser* parser, const char* nex_filename);
+void init_output_mode(void);
+int write_atomically(const char* filename, const void* data, size_t size,
+                     const void* prefix, size_t prefix_size);
+void executable_filename(char* nex_filename, const char* output_filename);
 
-int find_instruction(const Instruction* instructions, int num_instructions, const char* mnemonic);
+int find_instruction(const Instruction* instructions, int num_instructions, Token mnemonic);
 
 #endif // PARSER_H
\ No newline at end of file
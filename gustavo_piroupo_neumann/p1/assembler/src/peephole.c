@@ -0,0 +1,212 @@
+#include <string.h>
+#include "peephole.h"
+
+#define OP_NOP 0x00
+#define OP_STA 0x10
+#define OP_LDA 0x20
+#define OP_NOT 0x60
+#define OP_JMP 0x80
+#define OP_JN  0x90
+#define OP_JZ  0xA0
+#define OP_HLT 0xF0
+
+#define ADDRESS_SPACE 256   // Enderecos do Neander
+
+static int is_jump(unsigned short opcode) {
+    return opcode == OP_JMP || opcode == OP_JN || opcode == OP_JZ;
+}
+
+// Primeira instrucao viva a partir de i; count se nenhuma
+static int resolve(const unsigned char* removed, int count, int i) {
+    while (i < count && removed[i]) {
+        i++;
+    }
+    return i;
+}
+
+// Instrucao viva em que o desvio para target cai
+static int jump_index(const int* index_at, const unsigned char* removed, int count, int target) {
+    return resolve(removed, count, index_at[target]);
+}
+
+// O codigo pode ser movido: uma secao .CODE a partir de 0, sem dados em
+// cima, sem leituras ou escritas de dados no codigo, desvios so para o
+// inicio de instrucoes e sem cair para fora do fim. O que vem depois do
+// codigo muda de lugar, entao nao pode ser executado.
+static int can_optimize(const Parser* parser, int code_end, const int* index_at) {
+    if (parser->code_count == 0 || parser->code_count >= MEMORY_SIZE) return 0;
+    if (code_end > ADDRESS_SPACE) return 0;
+
+    int address = 0;
+    for (int i = 0; i < parser->code_count; i++) {
+        const ParsedInstruction* instr = &parser->code[i];
+        if (instr->address != address) return 0;
+        address += instr->length;
+    }
+
+    for (int a = 0; a < code_end; a++) {
+        if (parser->is_data[a]) return 0;
+    }
+
+    unsigned short last = parser->code[parser->code_count - 1].opcode;
+    if (last != OP_HLT && last != OP_JMP) return 0;
+
+    for (int i = 0; i < parser->code_count; i++) {
+        const ParsedInstruction* instr = &parser->code[i];
+        if (instr->length != 2 || instr->opcode == OP_NOP) continue;
+        if (instr->operand >= ADDRESS_SPACE) return 0;
+
+        if (is_jump(instr->opcode)) {
+            if (instr->operand >= code_end || index_at[instr->operand] < 0) return 0;
+        } else if (instr->operand < code_end) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Marca os inicios de bloco basico: a entrada, os destinos de desvio e as
+// instrucoes depois de um desvio
+static void find_leaders(const Parser* parser, const int* index_at, const unsigned char* removed,
+                         unsigned char* leader) {
+    int count = parser->code_count;
+
+    memset(leader, 0, count + 1);
+    leader[resolve(removed, count, 0)] = 1;
+
+    for (int i = 0; i < count; i++) {
+        if (removed[i] || !is_jump(parser->code[i].opcode)) continue;
+
+        leader[jump_index(index_at, removed, count, parser->code[i].operand)] = 1;
+        leader[resolve(removed, count, i + 1)] = 1;
+    }
+}
+
+// O executor mostra no fim os flags do AC antes da ultima instrucao que
+// nao e HLT; remover a instrucao que precede um HLT mudaria esses flags
+static int before_halt(const Parser* parser, const unsigned char* removed, int count, int i) {
+    int next = resolve(removed, count, i + 1);
+    return next < count && parser->code[next].opcode == OP_HLT;
+}
+
+// Aplica um padrao; devolve quantas instrucoes removeu
+static int apply_pattern(const Parser* parser, const int* index_at, unsigned char* removed,
+                         const unsigned char* leader, int i, int j) {
+    int count = parser->code_count;
+    const ParsedInstruction* a = &parser->code[i];
+
+    // JMP para a instrucao seguinte
+    if (a->opcode == OP_JMP && jump_index(index_at, removed, count, a->operand) == j &&
+        !before_halt(parser, removed, count, i)) {
+        removed[i] = 1;
+        return 1;
+    }
+    if (j == count) return 0;
+
+    const ParsedInstruction* b = &parser->code[j];
+
+    // STA x; LDA x: o AC ja tem o valor de x
+    if (a->opcode == OP_STA && b->opcode == OP_LDA && a->operand == b->operand && !leader[j]) {
+        removed[j] = 1;
+        return 1;
+    }
+
+    // LDA a; LDA b: a primeira carga nunca e usada
+    if (a->opcode == OP_LDA && b->opcode == OP_LDA && !before_halt(parser, removed, count, j)) {
+        removed[i] = 1;
+        return 1;
+    }
+
+    // NOT; NOT
+    if (a->opcode == OP_NOT && b->opcode == OP_NOT && !leader[j] &&
+        !before_halt(parser, removed, count, j)) {
+        removed[i] = 1;
+        removed[j] = 1;
+        return 2;
+    }
+
+    return 0;
+}
+
+int peephole_optimize(Parser* parser) {
+    int count = parser->code_count;
+    int index_at[ADDRESS_SPACE];
+    unsigned char removed[MEMORY_SIZE] = {0};
+    unsigned char leader[MEMORY_SIZE + 1];
+
+    if (count == 0 || count >= MEMORY_SIZE) return PEEPHOLE_SKIPPED;
+
+    int code_end = parser->code[count - 1].address + parser->code[count - 1].length;
+    if (code_end > ADDRESS_SPACE) return PEEPHOLE_SKIPPED;
+
+    for (int a = 0; a < ADDRESS_SPACE; a++) {
+        index_at[a] = -1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (parser->code[i].address >= 0 && parser->code[i].address < ADDRESS_SPACE) {
+            index_at[parser->code[i].address] = i;
+        }
+    }
+
+    if (!can_optimize(parser, code_end, index_at)) return PEEPHOLE_SKIPPED;
+
+    // Repete ate nenhum padrao se aplicar: uma remocao pode criar outro par
+    int total = 0;
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        find_leaders(parser, index_at, removed, leader);
+
+        for (int i = resolve(removed, count, 0); i < count; i = resolve(removed, count, i + 1)) {
+            int j = resolve(removed, count, i + 1);
+            int n = apply_pattern(parser, index_at, removed, leader, i, j);
+            if (n) {
+                total += n;
+                changed = 1;
+                break;
+            }
+        }
+    }
+
+    if (total == 0) return 0;
+
+    // Novos enderecos; os removidos caem na proxima instrucao viva, e a
+    // ultima (HLT ou JMP) nunca e removida
+    int new_address[MEMORY_SIZE];
+    int address = 0;
+    for (int i = 0; i < count; i++) {
+        new_address[i] = address;
+        if (!removed[i]) address += parser->code[i].length;
+    }
+    int new_end = address;
+
+    for (int a = 0; a < code_end; a++) {
+        parser->memory[a] = 0;
+    }
+
+    int live = 0;
+    for (int i = 0; i < count; i++) {
+        if (removed[i]) continue;
+
+        ParsedInstruction instr = parser->code[i];
+        if (is_jump(instr.opcode)) {
+            instr.operand = new_address[index_at[instr.operand]];
+        }
+        instr.address = new_address[i];
+
+        parser->memory[instr.address] = instr.opcode;
+        if (instr.length == 2) {
+            parser->memory[instr.address + 1] = instr.operand;
+        }
+        parser->code[live++] = instr;
+    }
+    parser->code_count = live;
+
+    parser->max_address = new_end;
+    if (parser->data_max_address > parser->max_address) {
+        parser->max_address = parser->data_max_address;
+    }
+
+    return total;
+}
@@ -0,0 +1,23 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include "parser.h"
+
+#define PEEPHOLE_SKIPPED -1
+
+// Otimizacao opcional entre parser_parse e parser_write_output. Remove,
+// dentro dos blocos basicos:
+//
+//   STA x; LDA x   ->  STA x
+//   LDA a; LDA b   ->  LDA b
+//   NOT; NOT       ->  (nada)
+//   JMP proximo    ->  (nada)
+//
+// e reloca os operandos dos desvios. Devolve o numero de instrucoes
+// removidas, ou PEEPHOLE_SKIPPED se o codigo nao puder ser movido com
+// seguranca: mais de uma secao .CODE, dados sobre o codigo, acesso de
+// dados ao codigo (codigo automodificavel), desvio para fora do codigo ou
+// para o meio de uma instrucao, ou codigo que nao termina em HLT ou JMP.
+int peephole_optimize(Parser* parser);
+
+#endif // PEEPHOLE_H
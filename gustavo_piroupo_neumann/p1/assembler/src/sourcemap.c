@@ -0,0 +1,82 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sourcemap.h"
+
+// Mapa do compilador: para cada linha do .asm, o resto da linha do mapa
+// (linha do .lpn, comando e operacao), guardado como veio
+typedef struct {
+    char** columns;
+    int lines;
+} CompilerMap;
+
+static void read_compiler_map(CompilerMap* map, const char* filename) {
+    map->columns = NULL;
+    map->lines = 0;
+
+    FILE* file = fopen(filename, "r");
+    if (!file) return;
+
+    char line[PATH_LENGTH];
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == ';' || line[0] == '\0') continue;
+
+        char* tab = strchr(line, '\t');
+        int asm_line = atoi(line);
+        if (!tab || asm_line <= 0) continue;
+
+        if (asm_line > map->lines) {
+            map->columns = realloc(map->columns, asm_line * sizeof(char*));
+            memset(map->columns + map->lines, 0, (asm_line - map->lines) * sizeof(char*));
+            map->lines = asm_line;
+        }
+        free(map->columns[asm_line - 1]);
+        map->columns[asm_line - 1] = strdup(tab + 1);
+    }
+
+    fclose(file);
+}
+
+static void free_compiler_map(CompilerMap* map) {
+    for (int i = 0; i < map->lines; i++) {
+        free(map->columns[i]);
+    }
+    free(map->columns);
+}
+
+int sourcemap_write(const Parser* parser, const char* input_filename, const char* map_filename) {
+    char compiler_filename[PATH_LENGTH];
+    snprintf(compiler_filename, sizeof(compiler_filename), "%s.map", input_filename);
+
+    CompilerMap compiler_map;
+    read_compiler_map(&compiler_map, compiler_filename);
+
+    char* buffer = NULL;
+    size_t size = 0;
+    FILE* output = open_memstream(&buffer, &size);
+    if (!output) {
+        free_compiler_map(&compiler_map);
+        fprintf(stderr, "Error: out of memory\n");
+        return 0;
+    }
+
+    fprintf(output, "; endereco, linha do .asm, linha do .lpn, comando, operacao\n");
+    for (int i = 0; i < parser->code_count; i++) {
+        const ParsedInstruction* instr = &parser->code[i];
+        const char* columns = NULL;
+        if (instr->line > 0 && instr->line <= compiler_map.lines) {
+            columns = compiler_map.columns[instr->line - 1];
+        }
+        fprintf(output, "0x%02X\t%d\t%s\n", instr->address, instr->line, columns ? columns : "0\t\t");
+    }
+    fclose(output);
+
+    int ok = write_atomically(map_filename, buffer, size, NULL, 0);
+    if (!ok) {
+        fprintf(stderr, "Error creating map file: %s\n", map_filename);
+    }
+
+    free(buffer);
+    free_compiler_map(&compiler_map);
+    return ok;
+}
@@ -0,0 +1,12 @@
+#ifndef SOURCEMAP_H
+#define SOURCEMAP_H
+
+#include "parser.h"
+
+// Mapa de fontes do montador, uma linha por instrucao, campos separados
+// por tabulacao: endereco (0xNN), linha do .asm e, se o compilador gerou
+// <entrada>.map, a linha do .lpn, o comando e a operacao. Sem o mapa do
+// compilador esses campos ficam 0 e vazios.
+int sourcemap_write(const Parser* parser, const char* input_filename, const char* map_filename);
+
+#endif // SOURCEMAP_H
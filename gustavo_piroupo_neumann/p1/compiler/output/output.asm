@@ -0,0 +1,60 @@
+.DATA
+0x80 0x0
+0x81 0x1
+0x82 0xFF
+0x83 0x0
+0x84 0x0
+0x85 0x0
+0x86 0x0
+0x87 0x5
+0x88 0xA
+0x89 0x2
+0x8A 0x3
+.CODE
+LDA 0x87
+STA 0xC8
+LDA 0xC8
+STA 0x83
+LDA 0x88
+STA 0xC8
+LDA 0xC8
+STA 0x84
+LDA 0x83
+STA 0xC8
+LDA 0x84
+STA 0xC9
+LDA 0x80
+STA 0xCA
+LDA 0xC8
+STA 0xCB
+LDA 0xCB
+JZ 0x32
+LDA 0xCA
+ADD 0xC9
+STA 0xCA
+LDA 0xCB
+ADD 0x82
+STA 0xCB
+JMP 0x20
+LDA 0xCA
+STA 0x85
+LDA 0x85
+STA 0xC8
+LDA 0x89
+STA 0xC9
+LDA 0xC9
+NOT
+ADD 0x81
+STA 0xC9
+LDA 0xC8
+ADD 0xC9
+STA 0xCA
+LDA 0x8A
+STA 0xC8
+LDA 0xCA
+ADD 0xC8
+STA 0xC9
+LDA 0xC9
+STA 0x86
+LDA 0x86
+HLT
@@ -11,6 +11,8 @@
 
 #define INITIAL_MEMORY_ADDRESS 0x80 // 80 in hexadecimal
 #define TEMP_MEMORY_START 0xC8 // 200 in decimal (C8 in hex)
+#define TEMP_MEMORY_END 0xFF   // Último endereço temporário
+#define TEMP_SLOTS (TEMP_MEMORY_END - TEMP_MEMORY_START + 1)
 #define CODE_START_ADDRESS 0x00 // Endereço onde começa o código
 
 // Tipos de tokens
@@ -46,6 +48,9 @@ typedef struct {
     InstructionType type;
     int operand;    
     int address;    
+    int source;         // Índice do comando em lines de compile(), -1 se nenhum
+    int expr_start;     // Trecho do comando que gerou a instrução, -1 se é o comando todo
+    int expr_end;
 } Instruction;
 
 // Estrutura do token
@@ -76,10 +81,15 @@ typedef struct {
     Variable variables[MAX_VARIABLES];
     int var_count;
     int next_address;
-    int temp_address;
+    unsigned char temp_in_use[TEMP_SLOTS]; // Temporários com valor ainda não consumido
+    int failed;            // Erro que impede gerar o programa
     Instruction instructions[MAX_INSTRUCTIONS];
     int instruction_count;
     Lexer lexer;
+    int current_source;    // Comando sendo compilado, para o mapa de fontes
+    int expression_offset; // Posição da expressão dentro do comando
+    int expr_start;        // Operação sendo compilada, -1 se nenhuma
+    int expr_end;
 } Compiler;
 
 // Forward declarations para o parser recursivo descendente
@@ -91,8 +101,13 @@ int parse_factor(Compiler *c);
 void init_compiler(Compiler *c) {
     c->var_count = 0;
     c->next_address = INITIAL_MEMORY_ADDRESS;
-    c->temp_address = TEMP_MEMORY_START;
+    memset(c->temp_in_use, 0, sizeof(c->temp_in_use));
+    c->failed = 0;
     c->instruction_count = 0;
+    c->current_source = -1;
+    c->expression_offset = 0;
+    c->expr_start = -1;
+    c->expr_end = -1;
 }
 
 // Adiciona uma instrução ao compilador
@@ -105,6 +120,9 @@ int add_instruction(Compiler *c, InstructionType type, int operand) {
     c->instructions[c->instruction_count].type = type;
     c->instructions[c->instruction_count].operand = operand;
     c->instructions[c->instruction_count].address = c->instruction_count;
+    c->instructions[c->instruction_count].source = c->current_source;
+    c->instructions[c->instruction_count].expr_start = c->expr_start;
+    c->instructions[c->instruction_count].expr_end = c->expr_end;
     
     return c->instruction_count++;
 }
@@ -157,8 +175,29 @@ int add_constant(Compiler *c, int value) {
     return add_variable(c, constant_name, value, 1);
 }
 
+// Menor temporário livre. Cada temporário é liberado com release_temp
+// quando o valor é consumido, então uma expressão usa só os que estão
+// vivos ao mesmo tempo.
 int get_temp_address(Compiler *c) {
-    return c->temp_address++;
+    for (int i = 0; i < TEMP_SLOTS; i++) {
+        if (!c->temp_in_use[i]) {
+            c->temp_in_use[i] = 1;
+            return TEMP_MEMORY_START + i;
+        }
+    }
+    
+    if (!c->failed) {
+        fprintf(stderr, "Error: Expression too complex, out of temporary memory (0x%X-0x%X)\n",
+                TEMP_MEMORY_START, TEMP_MEMORY_END);
+    }
+    c->failed = 1;
+    return TEMP_MEMORY_START;
+}
+
+void release_temp(Compiler *c, int address) {
+    if (address >= TEMP_MEMORY_START && address <= TEMP_MEMORY_END) {
+        c->temp_in_use[address - TEMP_MEMORY_START] = 0;
+    }
 }
 
 // Funções para o lexer
@@ -255,6 +294,20 @@ int match(Lexer *lexer, TokenType type) {
     return 0;
 }
 
+// Marca as instruções geradas a seguir como da operação que começa em
+// start (posição de um token na expressão) e termina no token atual
+void begin_operation(Compiler *c, int start, int saved[2]) {
+    saved[0] = c->expr_start;
+    saved[1] = c->expr_end;
+    c->expr_start = c->expression_offset + start;
+    c->expr_end = c->expression_offset + c->lexer.current_token.position;
+}
+
+void end_operation(Compiler *c, const int saved[2]) {
+    c->expr_start = saved[0];
+    c->expr_end = saved[1];
+}
+
 // Funções auxiliares
 void clean_line(char *line) {
     char *comment = strchr(line, ';');
@@ -321,6 +374,8 @@ void generate_multiplication(Compiler *c, int operand1_addr, int operand2_addr,
     
     // Atualiza o endereço de saída do JZ
     modify_instruction(c, jz_instr, INSTR_JZ, c->instruction_count * 2);
+    
+    release_temp(c, counter_addr);
 }
 
 // Parser recursivo descendente
@@ -356,6 +411,7 @@ int parse_factor(Compiler *c) {
         // Verifica se há ')' após a expressão
         if (lexer->current_token.type != TOKEN_RPAREN) {
             fprintf(stderr, "Error: Expected closing parenthesis\n");
+            release_temp(c, expr_result);
             return result_addr; // Retorna o endereço para continuar a compilação
         }
         advance(lexer); // Consome ')'
@@ -363,20 +419,26 @@ int parse_factor(Compiler *c) {
         // Copia o resultado da expressão para o endereço de resultado
         load_accumulator(c, expr_result);
         store_accumulator(c, result_addr);
+        release_temp(c, expr_result);
     }
     // Trata números negativos (como unário -factor)
     else if (lexer->current_token.type == TOKEN_MINUS) {
+        int start = lexer->current_token.position;
         advance(lexer); // Consome '-'
         
         // Parse o fator que segue o -
         int factor_addr = parse_factor(c);
         
         // Calcular o complemento de 2 para negar o valor
+        int saved[2];
+        begin_operation(c, start, saved);
         load_accumulator(c, factor_addr);
         add_instruction(c, INSTR_NOT, -1);
         int one_idx = add_variable(c, "_one", 1, 1);
         add_instruction(c, INSTR_ADD, c->variables[one_idx].address);
         store_accumulator(c, result_addr);
+        end_operation(c, saved);
+        release_temp(c, factor_addr);
     }
     else {
         fprintf(stderr, "Error: Unexpected token in factor\n");
@@ -389,6 +451,7 @@ int parse_factor(Compiler *c) {
 
 int parse_term(Compiler *c) {
     Lexer *lexer = &c->lexer;
+    int start = lexer->current_token.position;
     
     // Parse o primeiro fator
     int left_addr = parse_factor(c);
@@ -402,7 +465,12 @@ int parse_term(Compiler *c) {
         int result_addr = get_temp_address(c);
         
         // Gera código para multiplicação
+        int saved[2];
+        begin_operation(c, start, saved);
         generate_multiplication(c, left_addr, right_addr, result_addr);
+        end_operation(c, saved);
+        release_temp(c, left_addr);
+        release_temp(c, right_addr);
         
         // O resultado desta operação se torna o operando esquerdo para a próxima
         left_addr = result_addr;
@@ -413,6 +481,7 @@ int parse_term(Compiler *c) {
 
 int parse_expression(Compiler *c) {
     Lexer *lexer = &c->lexer;
+    int start = lexer->current_token.position;
     
     // Parse o primeiro termo
     int left_addr = parse_term(c);
@@ -428,6 +497,8 @@ int parse_expression(Compiler *c) {
         int result_addr = get_temp_address(c);
         
         // Gera código para a operação
+        int saved[2];
+        begin_operation(c, start, saved);
         if (op_type == TOKEN_PLUS) {
             load_accumulator(c, left_addr);
             add_instruction(c, INSTR_ADD, right_addr);
@@ -444,6 +515,9 @@ int parse_expression(Compiler *c) {
             add_instruction(c, INSTR_ADD, right_addr);
             store_accumulator(c, result_addr);
         }
+        end_operation(c, saved);
+        release_temp(c, left_addr);
+        release_temp(c, right_addr);
         
         // O resultado desta operação se torna o operando esquerdo para a próxima
         left_addr = result_addr;
@@ -466,6 +540,14 @@ void process_assignment(Compiler *c, const char *line) {
     int var_idx = add_variable(c, var_name, 0, 1);
     int var_addr = c->variables[var_idx].address;
     
+    // Posição da expressão no comando, como o sscanf a encontrou
+    const char *equals = strchr(line, '=');
+    const char *start = equals ? equals + 1 : line;
+    while (isspace((unsigned char)*start)) {
+        start++;
+    }
+    c->expression_offset = start - line;
+    
     // Configura o lexer para a expressão
     init_lexer(&c->lexer, expression);
     advance(&c->lexer); // Obtém o primeiro token
@@ -476,6 +558,7 @@ void process_assignment(Compiler *c, const char *line) {
     // Armazena o resultado na variável
     load_accumulator(c, result_addr);
     store_accumulator(c, var_addr);
+    release_temp(c, result_addr);
 }
 
 // Processa uma instrução RES
@@ -542,6 +625,43 @@ void generate_assembly_code(Compiler *c, FILE *output) {
     }
 }
 
+// Trecho de line entre start e end, sem os espaços das pontas
+void print_trimmed(FILE *output, const char *line, int start, int end) {
+    while (start < end && isspace((unsigned char)line[start])) {
+        start++;
+    }
+    while (end > start && isspace((unsigned char)line[end - 1])) {
+        end--;
+    }
+    fprintf(output, "%.*s", end - start, line + start);
+}
+
+// Mapa de fontes: para cada linha de instrução do .asm, a linha do .lpn,
+// o comando e a operação dentro dele que a gerou (vazia se é o comando
+// todo). Campos separados por tabulação.
+void generate_source_map(Compiler *c, char lines[][MAX_LINE_SIZE], const int *line_numbers,
+                         FILE *map) {
+    // .DATA, uma linha por variável e .CODE antes da primeira instrução
+    int first_line = c->var_count + 3;
+    
+    fprintf(map, "; linha do .asm, linha do .lpn, comando, operação\n");
+    for (int i = 0; i < c->instruction_count; i++) {
+        Instruction *instr = &c->instructions[i];
+        if (instr->source < 0) {
+            continue;
+        }
+        
+        const char *line = lines[instr->source];
+        fprintf(map, "%d\t%d\t", first_line + i, line_numbers[instr->source]);
+        print_trimmed(map, line, 0, strlen(line));
+        fprintf(map, "\t");
+        if (instr->expr_start >= 0) {
+            print_trimmed(map, line, instr->expr_start, instr->expr_end);
+        }
+        fprintf(map, "\n");
+    }
+}
+
 // Gera a seção de dados
 void generate_data_section(Compiler *c, FILE *output) {
     fprintf(output, ".DATA\n");
@@ -551,22 +671,33 @@ void generate_data_section(Compiler *c, FILE *output) {
 }
 
 // Função principal de compilação
-void compile(const char *source_code, FILE *output) {
+// Devolve 0 se houve um erro que impede gerar o programa
+int compile(const char *source_code, FILE *output, FILE *map) {
     Compiler compiler;
     init_compiler(&compiler);
     
     char lines[100][MAX_LINE_SIZE];
+    int line_numbers[100]; // Linha de cada comando no .lpn
     int line_count = 0;
+    int line_number = 0;
     
     char *code_copy = strdup(source_code);
-    char *line = strtok(code_copy, "\n");
+    char *line = code_copy;
     
-    while (line != NULL && line_count < 100) {
+    // Linhas vazias são descartadas, mas contam para a numeração
+    while (line != NULL && *line != '\0' && line_count < 100) {
+        char *next = strchr(line, '\n');
+        if (next) {
+            *next++ = '\0';
+        }
+        line_number++;
+        
         clean_line(line);
         if (strlen(line) > 0) {
+            line_numbers[line_count] = line_number;
             strcpy(lines[line_count++], line);
         }
-        line = strtok(NULL, "\n");
+        line = next;
     }
     
     free(code_copy);
@@ -608,6 +739,7 @@ void compile(const char *source_code, FILE *output) {
         }
         
         if (in_code_section) {
+            compiler.current_source = i;
             if (strncmp(lines[i], "RES ", 4) == 0) {
                 process_res(&compiler, lines[i]);
             } else if (strchr(lines[i], '=') != NULL) {
@@ -617,23 +749,37 @@ void compile(const char *source_code, FILE *output) {
     }
     
     // Adiciona instrução de halt
+    compiler.current_source = -1;
     add_instruction(&compiler, INSTR_HLT, -1);
     
+    if (compiler.failed) {
+        return 0;
+    }
+    
     // Gera código assembly final
     generate_data_section(&compiler, output);
     fprintf(output, ".CODE\n");
     generate_assembly_code(&compiler, output);
+    
+    if (map) {
+        generate_source_map(&compiler, lines, line_numbers, map);
+    }
+    return 1;
 }
 
 int main(int argc, char *argv[]) {
-    if (argc != 3) {
-        fprintf(stderr, "Usage: %s <input_file> <output_file>\n", argv[0]);
+    // -g grava também o mapa de fontes em <output_file>.map
+    int source_map = argc == 4 && strcmp(argv[1], "-g") == 0;
+    if (argc != 3 && !source_map) {
+        fprintf(stderr, "Usage: %s [-g] <input_file> <output_file>\n", argv[0]);
         return 1;
     }
+    const char *input_filename = argv[argc - 2];
+    const char *output_filename = argv[argc - 1];
     
-    FILE *input = fopen(argv[1], "r");
+    FILE *input = fopen(input_filename, "r");
     if (!input) {
-        fprintf(stderr, "Error opening input file: %s\n", argv[1]);
+        fprintf(stderr, "Error opening input file: %s\n", input_filename);
         return 1;
     }
     
@@ -646,14 +792,39 @@ int main(int argc, char *argv[]) {
     
     fclose(input);
     
-    FILE *output = fopen(argv[2], "w");
+    FILE *output = fopen(output_filename, "w");
     if (!output) {
-        fprintf(stderr, "Error opening output file: %s\n", argv[2]);
+        fprintf(stderr, "Error opening output file: %s\n", output_filename);
         return 1;
     }
     
-    compile(source_code, output);
+    FILE *map = NULL;
+    char map_filename[MAX_LINE_SIZE + 8];
+    snprintf(map_filename, sizeof(map_filename), "%s.map", output_filename);
+    if (source_map) {
+        map = fopen(map_filename, "w");
+        if (!map) {
+            fprintf(stderr, "Error opening map file: %s\n", map_filename);
+            fclose(output);
+            return 1;
+        }
+    }
+    
+    int ok = compile(source_code, output, map);
     fclose(output);
+    if (map) {
+        fclose(map);
+    }
+    
+    // Não deixa um .asm incompleto para trás
+    if (!ok) {
+        remove(output_filename);
+        if (map) {
+            remove(map_filename);
+        }
+        fprintf(stderr, "Compilation failed.\n");
+        return 1;
+    }
     
     printf("Compilation completed successfully!\n");
     return 0;
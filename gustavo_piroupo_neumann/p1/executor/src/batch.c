@@ -0,0 +1,248 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "neander.h"
+#include "watchdog.h"
+
+#define MAX_PATH_LENGTH 4096
+
+// Resultado compacto de um .mem
+typedef struct {
+    NeanderStatus status;
+    uint8_t ac;
+    uint8_t pc;
+    bool z;
+    bool n;
+    uint32_t memory_hash; // FNV-1a da memória final
+    bool cached;          // Resultado veio do cache
+    uint64_t steps;       // Instruções executadas
+    uint64_t length;      // NEANDER_LOOP: instruções por volta do ciclo
+    uint64_t entry_step;  // NEANDER_LOOP: primeira instrução do ciclo
+    uint8_t entry;        // NEANDER_LOOP: pc da entrada do ciclo
+} JobResult;
+
+typedef struct {
+    char **files;
+    int count;
+    JobResult *results;
+    const char *cache;    // Diretório do cache, NULL se desativado
+    bool detect;          // Watchdog: procura laços infinitos
+    uint64_t budget;      // Watchdog: limite de instruções por job, 0: sem limite
+    atomic_int next;      // Próximo job livre
+} Batch;
+
+// Cada thread tem a sua máquina e pega jobs até a lista acabar
+static void *worker(void *arg) {
+    Batch *batch = arg;
+    Neander neander;
+    Watchdog watchdog;
+
+    for (;;) {
+        int job = atomic_fetch_add(&batch->next, 1);
+        if (job >= batch->count) break;
+
+        JobResult *result = &batch->results[job];
+
+        init_neander(&neander);
+        if (batch->detect || batch->budget) {
+            init_watchdog(&watchdog, batch->detect, batch->budget);
+            neander.watchdog = &watchdog;
+        }
+
+        result->status = load_neander(&neander, batch->files[job]);
+        if (result->status == NEANDER_OK && batch->cache) {
+            CacheKey key;
+            cache_key(&key, &neander);
+            result->cached = cache_lookup(batch->cache, &key, &neander);
+            if (!result->cached) {
+                result->status = run(&neander);
+                if (result->status == NEANDER_OK) {
+                    cache_store(batch->cache, &key, &neander);
+                }
+            }
+        } else if (result->status == NEANDER_OK) {
+            result->status = run(&neander);
+        }
+
+        if (result->status == NEANDER_LOOP) {
+            result->length = watchdog.length;
+            result->entry_step = watchdog.entry_step;
+            result->entry = watchdog.entry;
+        }
+        result->steps = neander.steps;
+
+        result->ac = neander.ac;
+        result->pc = neander.pc;
+        result->z = neander.z;
+        result->n = neander.n;
+        result->memory_hash = memory_hash(&neander);
+    }
+
+    return NULL;
+}
+
+// Acrescenta os caminhos do manifesto, um por linha
+static int read_manifest(const char *filename, char ***files, int *count, int *capacity) {
+    FILE *manifest = fopen(filename, "r");
+    if (!manifest) {
+        fprintf(stderr, "Error opening manifest: %s\n", filename);
+        return 0;
+    }
+
+    char line[MAX_PATH_LENGTH];
+    while (fgets(line, sizeof(line), manifest)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0') continue;
+
+        if (*count == *capacity) {
+            *capacity *= 2;
+            *files = realloc(*files, *capacity * sizeof(char *));
+        }
+        (*files)[(*count)++] = strdup(line);
+    }
+
+    fclose(manifest);
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *output_filename = NULL;
+    const char *cache_directory = NULL;
+    uint64_t cache_limit = CACHE_DEFAULT_LIMIT;
+    bool detect = false;
+    uint64_t budget = 0;
+    int capacity = 64;
+    int count = 0;
+    char **files = malloc(capacity * sizeof(char *));
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_filename = argv[++i];
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            cache_directory = argv[++i];
+        } else if (strcmp(argv[i], "-C") == 0 && i + 1 < argc) {
+            cache_limit = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-w") == 0) {
+            detect = true;
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            budget = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            if (!read_manifest(argv[++i], &files, &count, &capacity)) {
+                return 1;
+            }
+        } else {
+            if (count == capacity) {
+                capacity *= 2;
+                files = realloc(files, capacity * sizeof(char *));
+            }
+            files[count++] = strdup(argv[i]);
+        }
+    }
+
+    if (count == 0) {
+        fprintf(stderr, "Usage: %s [-j threads] [-o results] [-l manifest] [-c dir [-C KB]] [-w] [-b steps] [file.mem ...]\n", argv[0]);
+        return 1;
+    }
+
+    if (cache_directory && !cache_open(cache_directory)) {
+        perror("Error opening cache directory");
+        return 1;
+    }
+
+    if (threads < 1) threads = 1;
+    if (threads > count) threads = count;
+
+    Batch batch;
+    batch.files = files;
+    batch.count = count;
+    batch.results = calloc(count, sizeof(JobResult));
+    batch.cache = cache_directory;
+    batch.detect = detect;
+    batch.budget = budget;
+    atomic_init(&batch.next, 0);
+
+    pthread_t *pool = malloc(threads * sizeof(pthread_t));
+    for (int i = 0; i < threads; i++) {
+        pthread_create(&pool[i], NULL, worker, &batch);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(pool[i], NULL);
+    }
+
+    FILE *output = stdout;
+    if (output_filename) {
+        output = fopen(output_filename, "w");
+        if (!output) {
+            fprintf(stderr, "Error opening output file: %s\n", output_filename);
+            return 1;
+        }
+    }
+
+    // Uma linha por job: arquivo, status, AC, PC, Z, N e hash da memória
+    int failed = 0;
+    int hits = 0;
+    int lookups = 0;
+    int loops = 0;
+    int over_budget = 0;
+    for (int i = 0; i < count; i++) {
+        JobResult *result = &batch.results[i];
+        hits += result->cached;
+
+        if (result->status == NEANDER_LOOP) {
+            fprintf(output, "%s loop length=%llu entry=%03d step=%llu\n", files[i],
+                    (unsigned long long)result->length, result->entry,
+                    (unsigned long long)result->entry_step);
+            failed++;
+            loops++;
+            lookups++;
+            continue;
+        }
+        if (result->status == NEANDER_BUDGET) {
+            fprintf(output, "%s budget steps=%llu pc=%03d\n", files[i],
+                    (unsigned long long)result->steps, result->pc);
+            failed++;
+            over_budget++;
+            lookups++;
+            continue;
+        }
+        if (result->status != NEANDER_OK) {
+            fprintf(output, "%s error %s\n", files[i], neander_status_string(result->status));
+            failed++;
+            continue;
+        }
+
+        fprintf(output, "%s ok ac=%03d pc=%03d z=%d n=%d mem=%08x\n", files[i],
+                result->ac, result->pc, result->z, result->n, result->memory_hash);
+        lookups++;
+    }
+
+    if (output != stdout) {
+        fclose(output);
+    }
+
+    fprintf(stderr, "%d jobs, %d failed, %d threads\n", count, failed, threads);
+    if (detect || budget) {
+        fprintf(stderr, "watchdog: %d infinite loops, %d over budget\n", loops, over_budget);
+    }
+    if (cache_directory) {
+        // Jobs que não carregaram não consultam o cache
+        fprintf(stderr, "cache: %d hits, %d misses, %.1f%% hit rate\n", hits, lookups - hits,
+                lookups ? 100.0 * hits / lookups : 0.0);
+        cache_trim(cache_directory, cache_limit * 1024);
+    }
+
+    for (int i = 0; i < count; i++) {
+        free(files[i]);
+    }
+    free(files);
+    free(batch.results);
+    free(pool);
+
+    return failed ? 1 : 0;
+}
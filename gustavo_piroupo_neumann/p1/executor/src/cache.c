@@ -0,0 +1,200 @@
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache.h"
+
+#define CACHE_PATH_LENGTH 4096
+// Cabeçalho, imagem inicial, registradores e memória finais e passos
+#define CACHE_ENTRY_SIZE (4 + 2 + 2 + 2 * MEMORY_SIZE + 4 + MEMORY_SIZE + 8)
+
+static const uint8_t cache_magic[4] = {'N', 'C', 'C', 'H'};
+static const char cache_suffix[] = ".ncc";
+
+typedef struct {
+    char name[64];
+    off_t size;
+    struct timespec used;
+} CacheFile;
+
+static uint64_t fnv1a64(uint64_t hash, const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+bool cache_open(const char *directory) {
+    return mkdir(directory, 0777) == 0 || errno == EEXIST;
+}
+
+void cache_key(CacheKey *key, const Neander *neander) {
+    const uint8_t versions[4] = {CACHE_VERSION, CACHE_ENGINE_VERSION, neander->ac, neander->pc};
+
+    key->ac = neander->ac;
+    key->pc = neander->pc;
+    memcpy(key->memory, neander->memory, MEMORY_SIZE);
+    memcpy(key->high, neander->high, MEMORY_SIZE);
+
+    key->hash = fnv1a64(14695981039346656037ull, versions, sizeof(versions));
+    key->hash = fnv1a64(key->hash, key->memory, MEMORY_SIZE);
+    key->hash = fnv1a64(key->hash, key->high, MEMORY_SIZE);
+}
+
+static void entry_path(char *path, const char *directory, const CacheKey *key) {
+    snprintf(path, CACHE_PATH_LENGTH, "%s/%016llx%s", directory, (unsigned long long)key->hash,
+             cache_suffix);
+}
+
+// Parte da entrada que identifica a execução: cabeçalho e imagem inicial
+static uint8_t *put_key(uint8_t *p, const CacheKey *key) {
+    memcpy(p, cache_magic, 4);
+    p[4] = CACHE_VERSION;
+    p[5] = CACHE_ENGINE_VERSION;
+    p[6] = key->ac;
+    p[7] = key->pc;
+    memcpy(p + 8, key->memory, MEMORY_SIZE);
+    memcpy(p + 8 + MEMORY_SIZE, key->high, MEMORY_SIZE);
+    return p + 8 + 2 * MEMORY_SIZE;
+}
+
+bool cache_lookup(const char *directory, const CacheKey *key, Neander *neander) {
+    char path[CACHE_PATH_LENGTH];
+    uint8_t entry[CACHE_ENTRY_SIZE];
+    uint8_t expected[8 + 2 * MEMORY_SIZE];
+
+    entry_path(path, directory, key);
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    size_t length = fread(entry, 1, sizeof(entry), file);
+    fclose(file);
+
+    size_t key_size = (size_t)(put_key(expected, key) - expected);
+    if (length != sizeof(entry) || memcmp(entry, expected, key_size) != 0) {
+        return false;
+    }
+
+    const uint8_t *p = entry + key_size;
+    neander->ac = p[0];
+    neander->pc = p[1];
+    neander->z = p[2] != 0;
+    neander->n = p[3] != 0;
+    memcpy(neander->memory, p + 4, MEMORY_SIZE);
+    p += 4 + MEMORY_SIZE;
+    neander->steps = 0;
+    for (int i = 7; i >= 0; i--) {
+        neander->steps = (neander->steps << 8) | p[i];
+    }
+
+    // Marca o uso para o LRU
+    utimensat(AT_FDCWD, path, NULL, 0);
+    return true;
+}
+
+bool cache_store(const char *directory, const CacheKey *key, const Neander *neander) {
+    char path[CACHE_PATH_LENGTH];
+    char temporary[CACHE_PATH_LENGTH];
+    uint8_t entry[CACHE_ENTRY_SIZE];
+
+    uint8_t *p = put_key(entry, key);
+    p[0] = neander->ac;
+    p[1] = neander->pc;
+    p[2] = neander->z;
+    p[3] = neander->n;
+    memcpy(p + 4, neander->memory, MEMORY_SIZE);
+    p += 4 + MEMORY_SIZE;
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(neander->steps >> (8 * i));
+    }
+
+    entry_path(path, directory, key);
+    snprintf(temporary, sizeof(temporary), "%s/.%016llx.XXXXXX", directory,
+             (unsigned long long)key->hash);
+
+    int fd = mkstemp(temporary);
+    if (fd < 0) {
+        return false;
+    }
+    fchmod(fd, 0644);
+    bool ok = write(fd, entry, sizeof(entry)) == (ssize_t)sizeof(entry);
+    if (close(fd) != 0) {
+        ok = false;
+    }
+    if (!ok || rename(temporary, path) != 0) {
+        unlink(temporary);
+        return false;
+    }
+    return true;
+}
+
+static int compare_used(const void *a, const void *b) {
+    const struct timespec *x = &((const CacheFile *)a)->used;
+    const struct timespec *y = &((const CacheFile *)b)->used;
+    if (x->tv_sec != y->tv_sec) return x->tv_sec < y->tv_sec ? -1 : 1;
+    if (x->tv_nsec != y->tv_nsec) return x->tv_nsec < y->tv_nsec ? -1 : 1;
+    return 0;
+}
+
+static bool is_entry(const char *name) {
+    size_t length = strlen(name);
+    size_t suffix = sizeof(cache_suffix) - 1;
+    return name[0] != '.' && length > suffix && length < sizeof(((CacheFile *)0)->name) &&
+           strcmp(name + length - suffix, cache_suffix) == 0;
+}
+
+bool cache_trim(const char *directory, uint64_t limit) {
+    DIR *dir = opendir(directory);
+    if (!dir) {
+        return false;
+    }
+
+    char path[CACHE_PATH_LENGTH];
+    CacheFile *files = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    uint64_t total = 0;
+    struct dirent *item;
+
+    while ((item = readdir(dir)) != NULL) {
+        struct stat info;
+        if (!is_entry(item->d_name)) continue;
+        snprintf(path, sizeof(path), "%s/%s", directory, item->d_name);
+        if (stat(path, &info) != 0) continue;
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            CacheFile *grown = realloc(files, capacity * sizeof(CacheFile));
+            if (!grown) {
+                free(files);
+                closedir(dir);
+                return false;
+            }
+            files = grown;
+        }
+        strcpy(files[count].name, item->d_name);
+        files[count].size = info.st_size;
+        files[count].used = info.st_mtim;
+        total += (uint64_t)info.st_size;
+        count++;
+    }
+    closedir(dir);
+
+    // Dos menos usados recentemente aos mais
+    if (count > 0) {
+        qsort(files, count, sizeof(CacheFile), compare_used);
+    }
+    for (size_t i = 0; i < count && total > limit; i++) {
+        snprintf(path, sizeof(path), "%s/%s", directory, files[i].name);
+        if (unlink(path) == 0) {
+            total -= (uint64_t)files[i].size;
+        }
+    }
+
+    free(files);
+    return true;
+}
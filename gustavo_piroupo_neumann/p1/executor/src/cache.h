@@ -0,0 +1,61 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdint.h>
+
+#include "neander.h"
+
+/*
+ * Cache em disco de resultados de run(): um arquivo por execução em um
+ * diretório, com nome dado pelo hash da imagem carregada (memória, bytes
+ * altos do .mem, AC e PC iniciais) e da versão do motor.
+ *
+ * Arquivo, inteiros em little-endian:
+ *
+ *   "NCCH"  magic
+ *   u8      versão do formato (CACHE_VERSION)
+ *   u8      versão do motor (CACHE_ENGINE_VERSION)
+ *   u8[2]   AC e PC iniciais
+ *   u8[256] memória inicial
+ *   u8[256] bytes altos do .mem
+ *   u8[4]   AC, PC, Z e N finais
+ *   u8[256] memória final
+ *   u64     instruções executadas
+ *
+ * A imagem inicial inteira é guardada e comparada na leitura, então uma
+ * colisão do hash é só um miss. A data de modificação é a do último uso
+ * e cache_trim apaga os menos usados recentemente.
+ */
+
+#define CACHE_VERSION 1
+// Mudar quando run() mudar de comportamento, invalida os resultados antigos
+#define CACHE_ENGINE_VERSION 1
+#define CACHE_DEFAULT_LIMIT 4096 // KB
+
+// Imagem inicial de uma execução e o seu hash
+typedef struct {
+    uint64_t hash;
+    uint8_t ac;
+    uint8_t pc;
+    uint8_t memory[MEMORY_SIZE];
+    uint8_t high[MEMORY_SIZE];
+} CacheKey;
+
+// Cria o diretório, se ainda não existe
+bool cache_open(const char *directory);
+
+// Chamado depois do load_neander, antes de run()
+void cache_key(CacheKey *key, const Neander *neander);
+
+// Se a imagem já está no cache, aplica o estado final em neander e
+// devolve true sem executar
+bool cache_lookup(const char *directory, const CacheKey *key, Neander *neander);
+
+// Grava o resultado de run(). A entrada é escrita em um arquivo temporário
+// e renomeada, então vários processos podem usar o mesmo diretório.
+bool cache_store(const char *directory, const CacheKey *key, const Neander *neander);
+
+// Apaga as entradas menos usadas até o diretório ocupar no máximo limit bytes
+bool cache_trim(const char *directory, uint64_t limit);
+
+#endif // CACHE_H
@@ -0,0 +1,161 @@
+#include "dump.h"
+
+// "%08x: xx -> xx\n" por byte alterado
+#define CHANGE_LINE_SIZE 19
+#define CHANGES_TEXT_SIZE (64 + MEMORY_SIZE * CHANGE_LINE_SIZE)
+// {"ac":...,"memory":[ + até 4 caracteres por byte + ]}
+#define JSON_TEXT_SIZE (64 + MEMORY_SIZE * 4 + 3)
+
+static const char hex_digits[] = "0123456789abcdef";
+
+static const struct {
+    const char *name;
+    DumpMode mode;
+} dump_modes[] = {
+    {"full", DUMP_FULL},
+    {"none", DUMP_NONE},
+    {"final", DUMP_FINAL},
+    {"changed", DUMP_CHANGED},
+    {"binary", DUMP_BINARY},
+    {"json", DUMP_JSON}
+};
+
+bool dump_mode_from_string(const char *name, DumpMode *mode) {
+    for (size_t i = 0; i < sizeof(dump_modes) / sizeof(dump_modes[0]); i++) {
+        if (strcmp(name, dump_modes[i].name) == 0) {
+            *mode = dump_modes[i].mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+static char *put_string(char *p, const char *text) {
+    size_t length = strlen(text);
+    memcpy(p, text, length);
+    return p + length;
+}
+
+static char *put_hex(char *p, uint32_t value, int digits) {
+    for (int i = digits - 1; i >= 0; i--) {
+        p[i] = hex_digits[value & 0x0F];
+        value >>= 4;
+    }
+    return p + digits;
+}
+
+// %03d
+static char *put_decimal3(char *p, uint8_t value) {
+    p[0] = (char)('0' + value / 100);
+    p[1] = (char)('0' + value / 10 % 10);
+    p[2] = (char)('0' + value % 10);
+    return p + 3;
+}
+
+// %d
+static char *put_decimal(char *p, uint8_t value) {
+    if (value >= 100) *p++ = (char)('0' + value / 100);
+    if (value >= 10) *p++ = (char)('0' + value / 10 % 10);
+    *p++ = (char)('0' + value % 10);
+    return p;
+}
+
+// AC, PC e flags, como no cabeçalho do dump
+static char *put_registers(char *p, const Neander *neander) {
+    p = put_string(p, "AC: ");
+    p = put_decimal3(p, neander->ac);
+    p = put_string(p, "  | PC: ");
+    p = put_decimal3(p, neander->pc);
+    p = put_string(p, "\nZ : ");
+    p = put_string(p, neander->z ? "true" : "false");
+    p = put_string(p, " | N : ");
+    p = put_string(p, neander->n ? "true" : "false");
+    return put_string(p, "\n");
+}
+
+// Reconstrói o layout de bytes do .mem (sem o cabeçalho) para o dump
+static void memory_layout(const Neander *neander, uint8_t dump[DUMP_SIZE]) {
+    memset(dump, 0, FILE_HEADER_SIZE);
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        dump[FILE_HEADER_SIZE + i * 2] = neander->memory[i];
+        dump[FILE_HEADER_SIZE + i * 2 + 1] = neander->high[i];
+    }
+}
+
+// Imprimir memória: todo o texto é montado num buffer e escrito de uma vez
+void print_memory(const Neander *neander, FILE *output) {
+    uint8_t dump[DUMP_SIZE];
+    char text[DUMP_TEXT_SIZE];
+    char *p = text;
+
+    memory_layout(neander, dump);
+    p = put_registers(p, neander);
+
+    for (size_t offset = 0; offset < DUMP_SIZE; offset += 16) {
+        p = put_hex(p, (uint32_t)offset, 8);
+        p = put_string(p, ": ");
+
+        for (size_t i = 0; i < 16; i++) {
+            if (offset + i < DUMP_SIZE) {
+                p = put_hex(p, dump[offset + i], 2);
+                *p++ = ' ';
+            } else {
+                p = put_string(p, "   ");
+            }
+        }
+
+        *p++ = '\n';
+    }
+
+    p = put_string(p, "\n\n");
+    fwrite(text, 1, (size_t)(p - text), output);
+}
+
+// Registradores finais e, para cada byte alterado desde o carregamento,
+// o offset no dump com o valor antigo e o novo
+void print_changes(const Neander *neander, const uint8_t loaded[MEMORY_SIZE], FILE *output) {
+    char text[CHANGES_TEXT_SIZE];
+    char *p = put_registers(text, neander);
+
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        if (neander->memory[i] == loaded[i]) continue;
+
+        p = put_hex(p, (uint32_t)(FILE_HEADER_SIZE + i * 2), 8);
+        p = put_string(p, ": ");
+        p = put_hex(p, loaded[i], 2);
+        p = put_string(p, " -> ");
+        p = put_hex(p, neander->memory[i], 2);
+        *p++ = '\n';
+    }
+
+    fwrite(text, 1, (size_t)(p - text), output);
+}
+
+// Memória final como um .mem válido, com cabeçalho
+void print_memory_binary(const Neander *neander, FILE *output) {
+    uint8_t image[FILE_SIZE];
+
+    memory_layout(neander, image);
+    memcpy(image, file_id, FILE_HEADER_SIZE);
+    fwrite(image, 1, FILE_SIZE, output);
+}
+
+void print_memory_json(const Neander *neander, FILE *output) {
+    char text[JSON_TEXT_SIZE];
+    char *p = text;
+
+    p = put_string(p, "{\"ac\":");
+    p = put_decimal(p, neander->ac);
+    p = put_string(p, ",\"pc\":");
+    p = put_decimal(p, neander->pc);
+    p = put_string(p, neander->z ? ",\"z\":true" : ",\"z\":false");
+    p = put_string(p, neander->n ? ",\"n\":true" : ",\"n\":false");
+    p = put_string(p, ",\"memory\":[");
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        if (i > 0) *p++ = ',';
+        p = put_decimal(p, neander->memory[i]);
+    }
+    p = put_string(p, "]}\n");
+
+    fwrite(text, 1, (size_t)(p - text), output);
+}
@@ -0,0 +1,29 @@
+#ifndef DUMP_H
+#define DUMP_H
+
+#include <stdio.h>
+
+#include "neander.h"
+
+// Linhas de 16 bytes do dump, a última incompleta
+#define DUMP_LINES ((DUMP_SIZE + 15) / 16)
+// Cabeçalho de AC/PC e flags, "%08zx: " + 16 * "xx " + '\n' por linha e o "\n\n" final
+#define DUMP_TEXT_SIZE (64 + DUMP_LINES * (10 + 16 * 3 + 1) + 2)
+
+typedef enum {
+    DUMP_FULL,     // Dump hexadecimal antes e depois da execução
+    DUMP_NONE,     // Nada
+    DUMP_FINAL,    // Só o dump hexadecimal final
+    DUMP_CHANGED,  // Só os bytes alterados desde o carregamento
+    DUMP_BINARY,   // Imagem .mem final, em binário
+    DUMP_JSON      // Estado final em JSON
+} DumpMode;
+
+bool dump_mode_from_string(const char *name, DumpMode *mode);
+
+void print_memory(const Neander *neander, FILE *output);
+void print_changes(const Neander *neander, const uint8_t loaded[MEMORY_SIZE], FILE *output);
+void print_memory_binary(const Neander *neander, FILE *output);
+void print_memory_json(const Neander *neander, FILE *output);
+
+#endif // DUMP_H
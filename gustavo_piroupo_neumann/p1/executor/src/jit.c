@@ -0,0 +1,328 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include "jit.h"
+
+#if defined(__x86_64__)
+
+#define JIT_BUFFER_SIZE 8192 // 256 instruções de no máximo 20 bytes + prólogo
+
+#define EXIT_HALT 1          // HLT alcançado
+#define EXIT_CODE_WRITE 2    // STA escreveu em um byte traduzido
+
+// Estado trocado entre o motor em C e o código gerado
+typedef struct {
+    uint8_t *memory;         // rbx
+    const void *entry;       // Endereço nativo da instrução em pc
+    uint8_t ac;              // al
+    uint8_t unused;
+    uint8_t flags_ac;        // cl: AC antes da última instrução
+    uint8_t unused2;
+    uint32_t exit;           // edx: pc | motivo << 8
+} JitState;
+
+_Static_assert(offsetof(JitState, entry) == 8, "layout usado pelo prólogo");
+_Static_assert(offsetof(JitState, ac) == 16, "layout usado pelo prólogo");
+_Static_assert(offsetof(JitState, flags_ac) == 18, "layout usado pelo prólogo");
+_Static_assert(offsetof(JitState, exit) == 20, "layout usado pelo epílogo");
+
+typedef struct {
+    size_t at;               // Posição do rel32
+    uint8_t target;          // Endereço Neander de destino
+} Fixup;
+
+typedef struct {
+    const uint8_t *memory;
+    uint8_t *buffer;
+    size_t length;
+    size_t epilogue;
+    int32_t label[MEMORY_SIZE];  // Offset nativo de cada instrução, -1 se não traduzida
+    bool start[MEMORY_SIZE];     // Início de instrução alcançável
+    bool code[MEMORY_SIZE];      // Byte lido como opcode ou operando
+    Fixup fixups[MEMORY_SIZE * 2];
+    int fixup_count;
+} Translator;
+
+// Mesmo mapeamento do interpretador: opcodes desconhecidos são NOP
+static uint8_t kind_of(uint8_t opcode) {
+    return (opcode & 0x0F) ? 0 : opcode >> 4;
+}
+
+static uint8_t next_of(const uint8_t *memory, uint8_t pc) {
+    return (uint8_t)(pc + (memory[pc] == NOT ? 1 : 2));
+}
+
+static void emit(Translator *t, const uint8_t *bytes, size_t length) {
+    memcpy(t->buffer + t->length, bytes, length);
+    t->length += length;
+}
+
+static void emit_u8(Translator *t, uint8_t byte) {
+    t->buffer[t->length++] = byte;
+}
+
+static void emit_u32(Translator *t, uint32_t value) {
+    memcpy(t->buffer + t->length, &value, 4);
+    t->length += 4;
+}
+
+static void emit_rel32_to(Translator *t, size_t target) {
+    emit_u32(t, (uint32_t)(int32_t)(target - (t->length + 4)));
+}
+
+static void emit_jump_to_label(Translator *t, uint8_t target) {
+    t->fixups[t->fixup_count].at = t->length;
+    t->fixups[t->fixup_count].target = target;
+    t->fixup_count++;
+    emit_u32(t, 0);
+}
+
+// mov edx, pc | motivo << 8; jmp epílogo
+static void emit_exit(Translator *t, uint8_t pc, uint32_t reason) {
+    emit_u8(t, 0xBA);
+    emit_u32(t, pc | reason << 8);
+    emit_u8(t, 0xE9);
+    emit_rel32_to(t, t->epilogue);
+}
+
+// op al, [rbx + address]
+static void emit_memory_op(Translator *t, uint8_t opcode, uint8_t address) {
+    emit_u8(t, opcode);
+    emit_u8(t, 0x83);
+    emit_u32(t, address);
+}
+
+// Marca as instruções alcançáveis a partir de pc e os bytes que elas leem
+static void discover(Translator *t, uint8_t pc) {
+    uint8_t stack[MEMORY_SIZE * 2 + 1];
+    int depth = 0;
+
+    stack[depth++] = pc;
+    while (depth > 0) {
+        uint8_t address = stack[--depth];
+        if (t->start[address]) continue;
+
+        uint8_t kind = kind_of(t->memory[address]);
+        t->start[address] = true;
+        t->code[address] = true;
+        if (t->memory[address] != NOT && t->memory[address] != HLT) {
+            t->code[(uint8_t)(address + 1)] = true;
+        }
+
+        uint8_t target = t->memory[(uint8_t)(address + 1)];
+        switch (kind) {
+            case HLT >> 4:
+                break;
+            case JMP >> 4:
+                stack[depth++] = target;
+                break;
+            case JN >> 4:
+            case JZ >> 4:
+                stack[depth++] = target;
+                stack[depth++] = next_of(t->memory, address);
+                break;
+            default:
+                stack[depth++] = next_of(t->memory, address);
+                break;
+        }
+    }
+}
+
+static bool is_halt(const Translator *t, uint8_t address) {
+    return t->memory[address] == HLT;
+}
+
+// Traduz a instrução em address; devolve false se ela não segue para a próxima
+static bool emit_instruction(Translator *t, uint8_t address) {
+    uint8_t opcode = t->memory[address];
+    uint8_t kind = kind_of(opcode);
+    uint8_t operand = t->memory[(uint8_t)(address + 1)];
+    uint8_t next = next_of(t->memory, address);
+    bool code_write = kind == (STA >> 4) && t->code[operand];
+
+    // Os flags só são observados no HLT: guarda o AC (mov cl, al) apenas
+    // antes de instruções que podem ser seguidas por um HLT
+    bool before_halt = false;
+    switch (kind) {
+        case HLT >> 4:
+            break;
+        case JMP >> 4:
+            before_halt = is_halt(t, operand);
+            break;
+        case JN >> 4:
+        case JZ >> 4:
+            before_halt = is_halt(t, operand) || is_halt(t, next);
+            break;
+        default:
+            before_halt = is_halt(t, next) || code_write;
+            break;
+    }
+    if (before_halt) {
+        emit(t, (const uint8_t[]){0x88, 0xC1}, 2);
+    }
+
+    switch (kind) {
+        case STA >> 4:
+            emit_memory_op(t, 0x88, operand);
+            if (code_write) {
+                emit_exit(t, next, EXIT_CODE_WRITE);
+                return false;
+            }
+            return true;
+        case LDA >> 4:
+            emit_memory_op(t, 0x8A, operand);
+            return true;
+        case ADD >> 4:
+            emit_memory_op(t, 0x02, operand);
+            return true;
+        case 0x4:
+            emit_memory_op(t, 0x0A, operand);
+            return true;
+        case 0x5:
+            emit_memory_op(t, 0x22, operand);
+            return true;
+        case NOT >> 4:
+            emit(t, (const uint8_t[]){0xF6, 0xD0}, 2);
+            return true;
+        case JMP >> 4:
+            emit_u8(t, 0xE9);
+            emit_jump_to_label(t, operand);
+            return false;
+        case JN >> 4:
+            emit(t, (const uint8_t[]){0x84, 0xC0, 0x0F, 0x88}, 4);
+            emit_jump_to_label(t, operand);
+            return true;
+        case JZ >> 4:
+            emit(t, (const uint8_t[]){0x84, 0xC0, 0x0F, 0x84}, 4);
+            emit_jump_to_label(t, operand);
+            return true;
+        case HLT >> 4:
+            emit_exit(t, address, EXIT_HALT);
+            return false;
+        default:
+            return true;
+    }
+}
+
+// Traduz tudo o que é alcançável a partir de pc
+static void translate(Translator *t, const uint8_t *memory, uint8_t pc) {
+    static const uint8_t prologue[] = {
+        0x53,                   // push rbx
+        0x48, 0x8B, 0x1F,       // mov rbx, [rdi]
+        0x0F, 0xB6, 0x47, 0x10, // movzx eax, byte [rdi + 16]
+        0x0F, 0xB6, 0x4F, 0x12, // movzx ecx, byte [rdi + 18]
+        0xFF, 0x67, 0x08        // jmp [rdi + 8]
+    };
+    static const uint8_t epilogue[] = {
+        0x88, 0x47, 0x10,       // mov [rdi + 16], al
+        0x88, 0x4F, 0x12,       // mov [rdi + 18], cl
+        0x89, 0x57, 0x14,       // mov [rdi + 20], edx
+        0x5B,                   // pop rbx
+        0xC3                    // ret
+    };
+
+    t->memory = memory;
+    t->length = 0;
+    t->fixup_count = 0;
+    memset(t->start, 0, sizeof(t->start));
+    memset(t->code, 0, sizeof(t->code));
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        t->label[i] = -1;
+    }
+
+    emit(t, prologue, sizeof(prologue));
+    t->epilogue = t->length;
+    emit(t, epilogue, sizeof(epilogue));
+
+    discover(t, pc);
+
+    // Emite cadeias de instruções seguindo o fluxo sequencial
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        uint8_t address = (uint8_t)i;
+        if (!t->start[address] || t->label[address] >= 0) continue;
+
+        for (;;) {
+            t->label[address] = (int32_t)t->length;
+            if (!emit_instruction(t, address)) break;
+
+            address = next_of(memory, address);
+            if (t->label[address] >= 0) {
+                emit_u8(t, 0xE9);
+                emit_rel32_to(t, (size_t)t->label[address]);
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < t->fixup_count; i++) {
+        size_t at = t->fixups[i].at;
+        int32_t rel = t->label[t->fixups[i].target] - (int32_t)(at + 4);
+        memcpy(t->buffer + at, &rel, 4);
+    }
+}
+
+NeanderStatus run_jit(Neander *neander) {
+    Translator *t = malloc(sizeof(Translator));
+    uint8_t *buffer = mmap(NULL, JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (!t || buffer == MAP_FAILED) {
+        free(t);
+        return run(neander);
+    }
+    t->buffer = buffer;
+
+    JitState state = {0};
+    state.memory = neander->memory;
+    state.ac = neander->ac;
+    state.flags_ac = neander->ac;
+
+    uint8_t pc = neander->pc;
+    bool executed = neander->memory[pc] != HLT;
+    bool halted = !executed;
+
+    for (int translations = 0; !halted; translations++) {
+        if (translations == JIT_MAX_TRANSLATIONS) {
+            // Código que se modifica demais: o interpretador termina
+            neander->ac = state.ac;
+            neander->pc = pc;
+            neander->predecoded = false; // O código nativo já escreveu na memória
+            munmap(buffer, JIT_BUFFER_SIZE);
+            free(t);
+            return run(neander);
+        }
+
+        mprotect(buffer, JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE);
+        translate(t, neander->memory, pc);
+        mprotect(buffer, JIT_BUFFER_SIZE, PROT_READ | PROT_EXEC);
+
+        void (*native)(JitState *);
+        void *entry = buffer;
+        memcpy(&native, &entry, sizeof(native));
+        state.entry = buffer + t->label[pc];
+        native(&state);
+
+        pc = (uint8_t)(state.exit & 0xFF);
+        // Depois de uma escrita em código, retraduz a partir de pc
+        halted = (state.exit >> 8) == EXIT_HALT || neander->memory[pc] == HLT;
+    }
+
+    neander->ac = state.ac;
+    neander->pc = pc;
+    if (executed) {
+        neander->z = (state.flags_ac == 0);
+        neander->n = (state.flags_ac & 0x80) != 0;
+    }
+
+    munmap(buffer, JIT_BUFFER_SIZE);
+    free(t);
+    return NEANDER_OK;
+}
+
+#else
+
+NeanderStatus run_jit(Neander *neander) {
+    return run(neander);
+}
+
+#endif
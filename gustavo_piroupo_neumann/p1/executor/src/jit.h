@@ -0,0 +1,12 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "neander.h"
+
+#define JIT_MAX_TRANSLATIONS 64 // Retraduções por escrita em código antes de voltar ao interpretador
+
+// Executa como run(), traduzindo o programa alcançável para x86-64.
+// Em outras arquiteturas usa o interpretador.
+NeanderStatus run_jit(Neander *neander);
+
+#endif // JIT_H
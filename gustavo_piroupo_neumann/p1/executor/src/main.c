@@ -0,0 +1,181 @@
+#include <stdlib.h>
+
+#include "cache.h"
+#include "dump.h"
+#include "jit.h"
+#include "neander.h"
+#include "profile.h"
+#include "sourcemap.h"
+#include "trace.h"
+
+int main(int argc, char const *argv[]) {
+    const char *filename = NULL;
+    bool profiling = false;
+    bool cycles = false;
+    bool jit = false;
+    DumpMode dump = DUMP_FULL;
+    const char *trace_filename = NULL;
+    size_t ring_records = 0;
+    const char *cache_directory = NULL;
+    uint64_t cache_limit = CACHE_DEFAULT_LIMIT;
+    const char *map_filename = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0) {
+            profiling = true;
+        } else if (strcmp(argv[i], "-y") == 0) {
+            cycles = true;
+        } else if (strcmp(argv[i], "-J") == 0) {
+            jit = true;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            trace_filename = argv[++i];
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            // Anel: os registros crus que cabem em KB
+            size_t kilobytes = strtoul(argv[++i], NULL, 10);
+            ring_records = kilobytes * 1024 / sizeof(TraceRecord);
+            if (ring_records == 0) ring_records = 1;
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            cache_directory = argv[++i];
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            map_filename = argv[++i];
+        } else if (strcmp(argv[i], "-C") == 0 && i + 1 < argc) {
+            cache_limit = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            if (!dump_mode_from_string(argv[++i], &dump)) {
+                fprintf(stderr, "Error: unknown dump mode '%s'\n", argv[i]);
+                return 1;
+            }
+        } else {
+            filename = argv[i];
+        }
+    }
+
+    if (!filename) {
+        fprintf(stderr, "Usage: %s [-p] [-y] [-J] [-t trace [-r KB]] [-c dir [-C KB]] [-m map] [-d full|none|final|changed|binary|json] <filename>\n", argv[0]);
+        return 1;
+    }
+
+    if ((profiling || cycles) && trace_filename) {
+        fprintf(stderr, "Error: -p and -y cannot be combined with -t\n");
+        return 1;
+    }
+
+    // Perfil, ciclos e trace só existem no interpretador
+    if (jit && (profiling || cycles || trace_filename)) {
+        fprintf(stderr, "Error: -J cannot be combined with -p, -y or -t\n");
+        return 1;
+    }
+
+    // O mapa de fontes só é usado no relatório do perfil
+    if (map_filename && !profiling) {
+        fprintf(stderr, "Error: -m needs -p\n");
+        return 1;
+    }
+
+    SourceMap map;
+    if (map_filename && !sourcemap_load(&map, map_filename)) {
+        perror("Error opening source map");
+        return 1;
+    }
+
+    // O cache guarda o resultado de run(), sem perfil, trace nem JIT
+    if (cache_directory && (profiling || cycles || trace_filename || jit)) {
+        fprintf(stderr, "Error: -c cannot be combined with -p, -y, -t or -J\n");
+        return 1;
+    }
+    if (cache_directory && !cache_open(cache_directory)) {
+        perror("Error opening cache directory");
+        return 1;
+    }
+
+    Neander neander;
+    init_neander(&neander);
+
+    NeanderStatus status = load_neander(&neander, filename);
+    if (status == NEANDER_ERROR_OPEN) {
+        perror("Error opening file");
+        return 1;
+    } else if (status != NEANDER_OK) {
+        fprintf(stderr, "Error: %s: %s\n", filename, neander_status_string(status));
+        return 1;
+    }
+
+    // O modelo de ciclos usa os contadores do perfil
+    Profile profile;
+    if (profiling || cycles) {
+        init_profile(&profile);
+        neander.profile = &profile;
+    }
+
+    Trace trace;
+    if (trace_filename) {
+        if (!trace_open(&trace, trace_filename, ring_records)) {
+            perror("Error opening trace file");
+            return 1;
+        }
+        neander.trace = &trace;
+    }
+
+    uint8_t loaded[MEMORY_SIZE];
+    memcpy(loaded, neander.memory, MEMORY_SIZE);
+
+    if (dump == DUMP_FULL) {
+        print_memory(&neander, stdout);
+    }
+
+    if (cache_directory) {
+        CacheKey key;
+        cache_key(&key, &neander);
+        bool hit = cache_lookup(cache_directory, &key, &neander);
+        if (!hit) {
+            status = run(&neander);
+            cache_store(cache_directory, &key, &neander);
+            cache_trim(cache_directory, cache_limit * 1024);
+        }
+        fprintf(stderr, "Cache %s: %llu steps\n", hit ? "hit" : "miss",
+                (unsigned long long)neander.steps);
+    } else if (jit) {
+        status = run_jit(&neander);
+    } else {
+        status = run(&neander);
+    }
+
+    if (trace_filename && !trace_close(&trace)) {
+        perror("Error writing trace file");
+        return 1;
+    }
+
+    switch (dump) {
+        case DUMP_FULL:
+        case DUMP_FINAL:
+            print_memory(&neander, stdout);
+            break;
+        case DUMP_CHANGED:
+            print_changes(&neander, loaded, stdout);
+            break;
+        case DUMP_BINARY:
+            print_memory_binary(&neander, stdout);
+            break;
+        case DUMP_JSON:
+            print_memory_json(&neander, stdout);
+            break;
+        case DUMP_NONE:
+            break;
+    }
+
+    if (profiling) {
+        print_profile(&profile, &neander, stdout);
+        if (map_filename) {
+            print_source_profile(&map, profile.executions, stdout);
+        }
+    }
+    if (map_filename) {
+        sourcemap_free(&map);
+    }
+    if (cycles) {
+        if (profiling) printf("\n");
+        print_cycles(&profile, stdout);
+    }
+
+    return status == NEANDER_OK ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+#include "dump.h"
+#include "neander.h"
+#include "translated.h"
+
+// Harness do programa traduzido: mesma saída do executor
+int main(int argc, char const *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <filename>\n", argv[0]);
+        return 1;
+    }
+
+    Neander neander;
+    init_neander(&neander);
+
+    NeanderStatus status = load_neander(&neander, argv[1]);
+    if (status == NEANDER_ERROR_OPEN) {
+        perror("Error opening file");
+        return 1;
+    } else if (status != NEANDER_OK) {
+        fprintf(stderr, "Error: %s: %s\n", argv[1], neander_status_string(status));
+        return 1;
+    }
+
+    // Sem a imagem traduzida o resultado é o do interpretador, não o nativo
+    if (!translated_image_matches(&neander)) {
+        fprintf(stderr, "Warning: %s is not the translated image (%s); running in the interpreter\n",
+                argv[1], translated_source);
+    }
+
+    print_memory(&neander, stdout);
+
+    status = run_translated(&neander);
+
+    print_memory(&neander, stdout);
+
+    return status == NEANDER_OK ? 0 : 1;
+}
@@ -1,4 +1,15 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "neander.h"
+#include "profile.h"
+#include "trace.h"
+#include "watchdog.h"
+
+const uint8_t file_id[FILE_HEADER_SIZE] = {0x03, 0x4e, 0x44, 0x52};
+const uint8_t nex_id[FILE_HEADER_SIZE] = {'N', 'E', 'X', 0x02};
 
 // Inicialização
 void init_neander(Neander *neander) {
@@ -7,111 +18,609 @@ void init_neander(Neander *neander) {
     neander->z = false;
     neander->n = false;
     memset(neander->memory, 0, MEMORY_SIZE); // Inicializa a memória com 0
+    memset(neander->high, 0, MEMORY_SIZE);
+    memset(neander->decoded, 0, MEMORY_SIZE);
+    memset(neander->leader, 0, sizeof(neander->leader));
+    neander->predecoded = false;
+    neander->steps = 0;
+    neander->profile = NULL;
+    neander->trace = NULL;
+    neander->watchdog = NULL;
 }
 
-// Imprimir memória
-void print_memory(const Neander *neander) {
-    size_t offset = 0;
+// Imagem e instruções do .nex. Cada registro precisa bater com a imagem.
+static NeanderStatus load_nex(Neander *neander, const uint8_t *image, size_t size) {
+    if (size < NEX_RECORDS_OFFSET) {
+        return NEANDER_ERROR_FORMAT;
+    }
 
-    printf("AC: %03d  | PC: %03d\n", neander->ac, neander->pc);
-    printf("Z : %s | N : %s\n", neander->z ? "true" : "false", neander->n ? "true" : "false");
+    const uint8_t *words = image + FILE_HEADER_SIZE;
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        neander->memory[i] = words[i * 2];
+        neander->high[i] = words[i * 2 + 1];
+    }
 
-    while (offset < MEMORY_SIZE) {
-        printf("%08zx: ", offset);
+    size_t count = image[NEX_COUNT_OFFSET] | (image[NEX_COUNT_OFFSET + 1] << 8);
+    if (count > MEMORY_SIZE || size < NEX_RECORDS_OFFSET + count * NEX_RECORD_SIZE) {
+        return NEANDER_ERROR_FORMAT;
+    }
 
-        for (size_t i = 0; i < 16; i++) {
-            if (offset + i < MEMORY_SIZE)
-                printf("%02x ", neander->memory[offset + i]);
-            else
-                printf("   ");
+    const uint8_t *record = image + NEX_RECORDS_OFFSET;
+    for (size_t i = 0; i < count; i++, record += NEX_RECORD_SIZE) {
+        uint8_t address = record[0];
+        uint8_t opcode = record[1];
+        if (neander->memory[address] != opcode || (opcode & 0x0F) ||
+            ((record[3] & NEX_OPERAND) && neander->memory[(uint8_t)(address + 1)] != record[2])) {
+            return NEANDER_ERROR_FORMAT;
         }
+        neander->decoded[address] = (opcode >> 4) + 1;
+        neander->leader[address] = (record[3] & NEX_LEADER) != 0;
+    }
+
+    neander->predecoded = true;
+    return NEANDER_OK;
+}
+
+// Mapeia o .mem, valida o cabeçalho 0x4e03 0x5244 e converte as palavras
+// de 16 bits para a memória nativa de uma única vez. Aceita também o .nex.
+NeanderStatus load_neander(Neander *neander, const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NEANDER_ERROR_OPEN;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return NEANDER_ERROR_OPEN;
+    }
+
+    if (st.st_size < FILE_HEADER_SIZE) {
+        close(fd);
+        return NEANDER_ERROR_FORMAT;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const uint8_t *image = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        return NEANDER_ERROR_OPEN;
+    }
+
+    if (memcmp(image, nex_id, FILE_HEADER_SIZE) == 0) {
+        NeanderStatus status = load_nex(neander, image, size);
+        munmap((void *)image, size);
+        return status;
+    }
+
+    if (memcmp(image, file_id, FILE_HEADER_SIZE) != 0) {
+        munmap((void *)image, size);
+        return NEANDER_ERROR_FORMAT;
+    }
 
-        printf("\n");
-        offset += 16;
+    if (size > FILE_SIZE) {
+        size = FILE_SIZE;
     }
 
-    printf("\n\n");
+    const uint8_t *words = image + FILE_HEADER_SIZE;
+    size_t bytes = size - FILE_HEADER_SIZE;
+    for (size_t i = 0; i < bytes / 2; i++) {
+        neander->memory[i] = words[i * 2];
+        neander->high[i] = words[i * 2 + 1];
+    }
+    if (bytes & 1) {
+        neander->memory[bytes / 2] = words[bytes - 1];
+    }
+
+    munmap((void *)image, (size_t)st.st_size);
+    return NEANDER_OK;
+}
+
+const char *neander_status_string(NeanderStatus status) {
+    switch (status) {
+        case NEANDER_OK:
+            return "ok";
+        case NEANDER_ERROR_OPEN:
+            return "cannot open file";
+        case NEANDER_ERROR_FORMAT:
+            return "invalid .mem or .nex file";
+        case NEANDER_LOOP:
+            return "infinite loop";
+        case NEANDER_BUDGET:
+            return "step budget exceeded";
+    }
+    return "unknown";
 }
 
-// Execução
-int run(Neander *neander) {
-    while (neander->memory[neander->pc] != HLT) {
-        // Atualiza os flags
-        neander->z = (neander->ac == 0);
-        neander->n = (neander->ac & 0x80) != 0;
-
-        // Calcula o endereço uma única vez
-        uint8_t address = neander->memory[neander->pc + 2];
-
-        // Decodifica e executa a instrução
-        switch (neander->memory[neander->pc]) {
-            case 0x00:
-                break;
-            case STA:
-                neander->memory[address * 2 + 4] = neander->ac;
-                break;
-            case LDA:
-                neander->ac = neander->memory[address * 2 + 4];
-                break;
-            case ADD:
-                neander->ac += neander->memory[address * 2 + 4];
-                break;
-            case 0x40:
-                neander->ac = neander->memory[address * 2 + 4] | neander->ac;
-                break;
-            case 0x50:
-                neander->ac = neander->memory[address * 2 + 4] & neander->ac;
-                break;
-            case NOT:
-                neander->ac = ~neander->ac;
-                neander->pc += 2;
-                continue;
-            case JMP:
-                neander->pc = address * 2 + 4;
-                continue;
-            case JN:
-                if (neander->n) {
-                    neander->pc = address * 2 + 4;
-                    continue;
-                }
-                break;
-            case JZ:
-                if (neander->z) {
-                    neander->pc = address * 2 + 4;
-                    continue;
-                }
-                break;
+// FNV-1a da memória, para comparar resultados sem imprimir o dump
+uint32_t memory_hash(const Neander *neander) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        hash = (hash ^ neander->memory[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Nome do mnemônico; opcodes desconhecidos são NOP
+const char *opcode_name(uint8_t opcode) {
+    static const char *const names[16] = {
+        "NOP", "STA", "LDA", "ADD", "OR",  "AND", "NOT", "NOP",
+        "JMP", "JN",  "JZ",  "NOP", "NOP", "NOP", "NOP", "HLT"
+    };
+    return (opcode & 0x0F) ? "NOP" : names[opcode >> 4];
+}
+
+// Pré-decodifica a instrução em pc: rótulo do opcode e endereço do operando.
+// Opcodes desconhecidos se comportam como NOP.
+#define DECODE(pc) do { \
+        uint8_t opcode_ = memory[(uint8_t)(pc)]; \
+        code[(uint8_t)(pc)].handler = dispatch[(opcode_ & 0x0F) ? 0 : opcode_ >> 4]; \
+        code[(uint8_t)(pc)].address = memory[(uint8_t)((pc) + 1)]; \
+    } while (0)
+
+#define DISPATCH() goto *code[pc].handler
+
+#define FUSED_SPAN 18 // Bytes da maior superinstrução (o laço de multiplicação)
+
+// Superinstruções, na ordem de fused_handlers em run()
+enum { FUSED_LDA_STA, FUSED_LDA_ADD_STA, FUSED_LDA_NOT_ADD_STA, FUSED_MULTIPLY };
+
+static bool in_span(uint8_t address, uint8_t start, int length) {
+    return (uint8_t)(address - start) < length;
+}
+
+// Laço de multiplicação por somas repetidas, como o de generate_multiplication
+// no compilador (os dois blocos podem vir em qualquer ordem):
+//
+//   L:  LDA c;  JZ E
+//       LDA r;  ADD b;  STA r    ; acumula
+//       LDA c;  ADD m;  STA c    ; decrementa, m contém 0xFF
+//       JMP L
+//   E:
+//
+// c, r, b e m precisam ser distintos e estar fora do laço. O conteúdo de m
+// é conferido na execução.
+static bool match_multiply(const uint8_t *memory, uint8_t start, DecodedInstr *instr) {
+    uint8_t at[9];
+    for (int i = 0; i < 9; i++) {
+        at[i] = (uint8_t)(start + i * 2);
+    }
+    static const uint8_t shape[9] = {LDA, JZ, LDA, ADD, STA, LDA, ADD, STA, JMP};
+    for (int i = 0; i < 9; i++) {
+        if (memory[at[i]] != shape[i]) return false;
+    }
+#define OPERAND(i) memory[(uint8_t)(at[i] + 1)]
+    if (OPERAND(8) != start) return false;
+
+    uint8_t counter = OPERAND(0);
+    int accumulate = (OPERAND(2) == counter) ? 5 : 2;
+    int decrement = (accumulate == 2) ? 5 : 2;
+    uint8_t result = OPERAND(accumulate);
+    uint8_t step = OPERAND(accumulate + 1);
+    uint8_t minus_one = OPERAND(decrement + 1);
+
+    bool shaped = OPERAND(accumulate + 2) == result &&
+                  OPERAND(decrement) == counter && OPERAND(decrement + 2) == counter;
+#undef OPERAND
+    if (!shaped) return false;
+
+    uint8_t cells[4] = {counter, result, step, minus_one};
+    for (int i = 0; i < 4; i++) {
+        if (in_span(cells[i], start, FUSED_SPAN)) return false;
+        for (int j = i + 1; j < 4; j++) {
+            if (cells[i] == cells[j]) return false;
         }
+    }
+
+    instr->address = counter;
+    instr->store = result;
+    instr->operand = step;
+    instr->decrement = minus_one;
+    instr->exit = memory[(uint8_t)(at[1] + 1)];
+    return true;
+}
 
-        neander->pc += 4;
+// Troca sequências retas geradas pelo compilador por uma superinstrução,
+// e o laço de multiplicação por uma multiplicação nativa.
+// Uma sequência não é fundida se alguma instrução depois da primeira é
+// alvo de desvio. fused marca os bytes lidos por superinstruções, para
+// que um STA neles desfaça a fusão.
+// Com o .nex (decoded e leader não nulos), os alvos são os começos de
+// bloco do montador e só os LDA do código são candidatos; sem ele, os
+// alvos vêm de todo byte da memória que parece um desvio.
+static void fuse(const uint8_t *memory, DecodedInstr *code, bool fused[MEMORY_SIZE],
+                 const void *const handlers[4], const uint8_t *decoded, const bool *leader) {
+    bool scanned[MEMORY_SIZE] = {false};
+    const bool *target = leader;
+
+    if (!leader) {
+        for (int i = 0; i < MEMORY_SIZE; i++) {
+            if (memory[i] == JMP || memory[i] == JN || memory[i] == JZ) {
+                scanned[memory[(uint8_t)(i + 1)]] = true;
+            }
+        }
+        target = scanned;
     }
 
-    print_memory(neander);
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        uint8_t pc = (uint8_t)i;
+        uint8_t second = (uint8_t)(pc + 2);
+        if (decoded && !decoded[pc]) continue; // Dado: não é executado
+        if (memory[pc] != LDA || target[second]) continue;
+
+        DecodedInstr *instr = &code[pc];
+        int length;
+
+        if (match_multiply(memory, pc, instr)) {
+            instr->handler = handlers[FUSED_MULTIPLY];
+            for (int j = 0; j < FUSED_SPAN; j++) {
+                fused[(uint8_t)(pc + j)] = true;
+            }
+            continue;
+        }
+
+        uint8_t third = (uint8_t)(pc + 4);
+        uint8_t not_add = (uint8_t)(pc + 3);
+        uint8_t not_sta = (uint8_t)(pc + 5);
 
-    return 0;
+        if (memory[second] == STA) {
+            instr->handler = handlers[FUSED_LDA_STA];
+            instr->store = memory[(uint8_t)(second + 1)];
+            length = 4;
+        } else if (memory[second] == ADD && memory[third] == STA && !target[third]) {
+            instr->handler = handlers[FUSED_LDA_ADD_STA];
+            instr->operand = memory[(uint8_t)(second + 1)];
+            instr->store = memory[(uint8_t)(third + 1)];
+            length = 6;
+        } else if (memory[second] == NOT && memory[not_add] == ADD && memory[not_sta] == STA &&
+                   !target[not_add] && !target[not_sta]) {
+            instr->handler = handlers[FUSED_LDA_NOT_ADD_STA];
+            instr->operand = memory[(uint8_t)(not_add + 1)];
+            instr->store = memory[(uint8_t)(not_sta + 1)];
+            length = 7;
+        } else {
+            continue;
+        }
+
+        for (int j = 0; j < length; j++) {
+            fused[(uint8_t)(pc + j)] = true;
+        }
+    }
 }
 
-int main(int argc, char const *argv[]) {
-    if (argc < 2) {
-        fprintf(stderr, "Usage: %s <filename>\n", argv[0]);
-        return 1;
+// Escreve o AC e invalida as instruções pré-decodificadas que leem o byte:
+// a de address, a de address - 1 e, se o byte pertence a uma
+// superinstrução, as que podem começar antes dele (voltam sem fusão)
+#define STORE(target) do { \
+        uint8_t target_ = (target); \
+        memory[target_] = ac; \
+        code[target_].handler = &&op_decode; \
+        code[(uint8_t)(target_ - 1)].handler = &&op_decode; \
+        if (fused[target_]) { \
+            for (int j_ = 2; j_ < FUSED_SPAN; j_++) { \
+                code[(uint8_t)(target_ - j_)].handler = &&op_decode; \
+            } \
+        } \
+    } while (0)
+
+// Execução até o HLT. Não usa estado global: várias instâncias podem
+// rodar em paralelo.
+NeanderStatus run(Neander *neander) {
+    static const void *const fast_dispatch[16] = {
+        &&op_nop, &&op_sta, &&op_lda, &&op_add, &&op_or,  &&op_and, &&op_not, &&op_nop,
+        &&op_jmp, &&op_jn,  &&op_jz,  &&op_nop, &&op_nop, &&op_nop, &&op_nop, &&op_hlt
+    };
+    // Com perfil ativo os rótulos contam e seguem para o handler normal,
+    // então o motor sem perfil não paga nada
+    static const void *const profile_dispatch[16] = {
+        &&prof_nop, &&prof_sta, &&prof_lda, &&prof_add, &&prof_or,  &&prof_and, &&prof_not, &&prof_nop,
+        &&prof_jmp, &&prof_jn,  &&prof_jz,  &&prof_nop, &&prof_nop, &&prof_nop, &&prof_nop, &&prof_hlt
+    };
+
+    // Com trace, os rótulos gravam a entrada e seguem para o handler normal
+    static const void *const trace_dispatch[16] = {
+        &&trace_nop, &&trace_sta, &&trace_lda, &&trace_add, &&trace_or,  &&trace_and, &&trace_not, &&trace_nop,
+        &&trace_jmp, &&trace_jn,  &&trace_jz,  &&trace_nop, &&trace_nop, &&trace_nop, &&trace_nop, &&trace_hlt
+    };
+
+    // Com watchdog, os rótulos verificam o estado quando o pc volta
+    static const void *const watch_dispatch[16] = {
+        &&watch_nop, &&watch_sta, &&watch_lda, &&watch_add, &&watch_or,  &&watch_and, &&watch_not, &&watch_nop,
+        &&watch_jmp, &&watch_jn,  &&watch_jz,  &&watch_nop, &&watch_nop, &&watch_nop, &&watch_nop, &&watch_hlt
+    };
+
+    Profile *profile = neander->profile;
+    Trace *trace = neander->trace;
+    // O cursor fica em variável local: as escritas na memória do Neander
+    // não obrigam a recarregá-lo
+    TraceRecord *trace_cursor = trace ? trace->cursor : NULL;
+    TraceRecord *trace_limit = trace ? trace->limit : NULL;
+    Watchdog *watchdog = neander->watchdog;
+    const void *const *dispatch = trace ? trace_dispatch : profile ? profile_dispatch :
+                                  watchdog ? watch_dispatch : fast_dispatch;
+    uint8_t *memory = neander->memory;
+    DecodedInstr *code = neander->code;
+    uint8_t ac = neander->ac;
+    uint8_t pc = neander->pc;
+    // Os flags só dependem do AC antes de cada instrução; guardamos esse
+    // valor e calculamos Z e N apenas em JN/JZ e no fim
+    uint8_t flags_ac = ac;
+    uint64_t steps = 0;
+    NeanderStatus status = NEANDER_OK;
+    int last_pc = -1;    // pc da instrução anterior, para o watchdog
+
+    static const void *const fused_handlers[4] = {
+        &&op_lda_sta, &&op_lda_add_sta, &&op_lda_not_add_sta, &&op_multiply
+    };
+    bool fused[MEMORY_SIZE] = {false};
+    bool predecoded = neander->predecoded;
+
+    if (predecoded) {
+        // .nex: as instruções já vêm decodificadas, e os dados só são
+        // decodificados se forem executados
+        for (int i = 0; i < MEMORY_SIZE; i++) {
+            uint8_t kind = neander->decoded[i];
+            code[i].handler = kind ? dispatch[kind - 1] : &&op_decode;
+            code[i].address = memory[(uint8_t)(i + 1)];
+        }
+        neander->predecoded = false; // A memória muda a partir daqui
+    } else {
+        for (int i = 0; i < MEMORY_SIZE; i++) {
+            DECODE(i);
+        }
+    }
+    // Perfil e trace contam instruções uma a uma
+    if (dispatch == fast_dispatch) {
+        fuse(memory, code, fused, fused_handlers,
+             predecoded ? neander->decoded : NULL, predecoded ? neander->leader : NULL);
     }
 
-    Neander neander;
-    init_neander(&neander);
+    bool executed = memory[pc] != HLT;
 
-    FILE *file = fopen(argv[1], "rb");
-    if (!file) {
-        perror("Error opening file");
-        return 1;
+    if (watchdog) {
+        watchdog_start(watchdog, neander);
     }
 
-    uint8_t file_id[4];
-    fread(file_id, 1, 4, file);
-    fread(neander.memory + 4, 1, 512, file);
-    fclose(file);
+    DISPATCH();
+
+op_decode:
+    // A instrução foi sobrescrita por um STA
+    DECODE(pc);
+    DISPATCH();
+
+op_nop:
+    steps++;
+    flags_ac = ac;
+    pc += 2;
+    DISPATCH();
+
+op_sta:
+    steps++;
+    flags_ac = ac;
+    STORE(code[pc].address);
+    pc += 2;
+    DISPATCH();
+
+op_lda:
+    steps++;
+    flags_ac = ac;
+    ac = memory[code[pc].address];
+    pc += 2;
+    DISPATCH();
+
+op_add:
+    steps++;
+    flags_ac = ac;
+    ac += memory[code[pc].address];
+    pc += 2;
+    DISPATCH();
+
+op_or:
+    steps++;
+    flags_ac = ac;
+    ac |= memory[code[pc].address];
+    pc += 2;
+    DISPATCH();
+
+op_and:
+    steps++;
+    flags_ac = ac;
+    ac &= memory[code[pc].address];
+    pc += 2;
+    DISPATCH();
+
+op_not:
+    steps++;
+    flags_ac = ac;
+    ac = ~ac;
+    pc += 1;
+    DISPATCH();
+
+// Superinstruções: os flags ficam com o AC antes do STA final
+op_lda_sta:
+    steps += 2;
+    ac = memory[code[pc].address];
+    flags_ac = ac;
+    STORE(code[pc].store);
+    pc += 4;
+    DISPATCH();
+
+op_lda_add_sta:
+    steps += 3;
+    ac = memory[code[pc].address] + memory[code[pc].operand];
+    flags_ac = ac;
+    STORE(code[pc].store);
+    pc += 6;
+    DISPATCH();
+
+op_lda_not_add_sta:
+    steps += 4;
+    ac = (uint8_t)~memory[code[pc].address] + memory[code[pc].operand];
+    flags_ac = ac;
+    STORE(code[pc].store);
+    pc += 7;
+    DISPATCH();
+
+// O laço inteiro de uma vez: r += c * b com wraparound e c = 0. Na saída
+// o último LDA c carregou 0 e os flags vêm do JZ, com AC 0.
+op_multiply:
+    if (memory[code[pc].decrement] != 0xFF) goto op_lda;
+    steps += 9 * (uint64_t)memory[code[pc].address] + 2; // 9 por volta, mais LDA c; JZ E
+    ac = memory[code[pc].store] + memory[code[pc].address] * memory[code[pc].operand];
+    STORE(code[pc].store);
+    ac = 0;
+    STORE(code[pc].address);
+    flags_ac = 0;
+    pc = code[pc].exit;
+    DISPATCH();
 
-    print_memory(&neander);
+op_jmp:
+    steps++;
+    flags_ac = ac;
+    pc = code[pc].address;
+    DISPATCH();
 
-    return run(&neander);
-}
\ No newline at end of file
+op_jn:
+    steps++;
+    flags_ac = ac;
+    pc = (ac & 0x80) ? code[pc].address : (uint8_t)(pc + 2);
+    DISPATCH();
+
+op_jz:
+    steps++;
+    flags_ac = ac;
+    pc = (ac == 0) ? code[pc].address : (uint8_t)(pc + 2);
+    DISPATCH();
+
+// O opcode é constante em cada rótulo, exceto nos NOPs, que podem ter
+// qualquer byte; o endereço só é gravado pelo STA. Cada passo grava só o
+// registro cru; o lote cheio é codificado fora do laço.
+#define TRACE_STEP(opcode, address, handler) \
+        *trace_cursor++ = TRACE_RECORD(pc, opcode, ac, address); \
+        if (trace_cursor == trace_limit) { \
+            trace_cursor = trace_flush(trace); \
+            trace_limit = trace->limit; \
+        } \
+        goto handler
+
+trace_nop: TRACE_STEP(memory[pc], 0, op_nop);
+trace_sta: TRACE_STEP(STA, code[pc].address, op_sta);
+trace_lda: TRACE_STEP(LDA, 0, op_lda);
+trace_add: TRACE_STEP(ADD, 0, op_add);
+trace_or:  TRACE_STEP(0x40, 0, op_or);
+trace_and: TRACE_STEP(0x50, 0, op_and);
+trace_not: TRACE_STEP(NOT, 0, op_not);
+trace_jmp: TRACE_STEP(JMP, 0, op_jmp);
+trace_jn:  TRACE_STEP(JN, 0, op_jn);
+trace_jz:  TRACE_STEP(JZ, 0, op_jz);
+trace_hlt: TRACE_STEP(HLT, 0, op_hlt);
+
+// pc <= last_pc: desvio para trás ou pc que deu a volta
+#define WATCH_CHECK() \
+        if (pc <= last_pc && !watchdog_check(watchdog, memory, pc, ac, steps)) goto watch_stop; \
+        last_pc = pc
+
+#define WATCH_STEP(handler) \
+        WATCH_CHECK(); \
+        goto handler
+
+watch_nop: WATCH_STEP(op_nop);
+watch_lda: WATCH_STEP(op_lda);
+watch_add: WATCH_STEP(op_add);
+watch_or:  WATCH_STEP(op_or);
+watch_and: WATCH_STEP(op_and);
+watch_not: WATCH_STEP(op_not);
+watch_jmp: WATCH_STEP(op_jmp);
+watch_jn:  WATCH_STEP(op_jn);
+watch_jz:  WATCH_STEP(op_jz);
+watch_hlt: WATCH_STEP(op_hlt);
+
+watch_sta:
+    WATCH_CHECK();
+    watchdog_store(watchdog, code[pc].address, memory[code[pc].address], ac);
+    goto op_sta;
+
+watch_stop:
+    status = watchdog->status;
+    goto finish;
+
+prof_nop:
+    profile->executions[pc]++;
+    profile->instructions[0]++;
+    goto op_nop;
+
+prof_sta:
+    profile->executions[pc]++;
+    profile->instructions[1]++;
+    profile->writes[code[pc].address]++;
+    goto op_sta;
+
+prof_lda:
+    profile->executions[pc]++;
+    profile->instructions[2]++;
+    profile->reads[code[pc].address]++;
+    goto op_lda;
+
+prof_add:
+    profile->executions[pc]++;
+    profile->instructions[3]++;
+    profile->reads[code[pc].address]++;
+    goto op_add;
+
+prof_or:
+    profile->executions[pc]++;
+    profile->instructions[4]++;
+    profile->reads[code[pc].address]++;
+    goto op_or;
+
+prof_and:
+    profile->executions[pc]++;
+    profile->instructions[5]++;
+    profile->reads[code[pc].address]++;
+    goto op_and;
+
+prof_not:
+    profile->executions[pc]++;
+    profile->instructions[6]++;
+    goto op_not;
+
+prof_jmp:
+    profile->executions[pc]++;
+    profile->instructions[8]++;
+    goto op_jmp;
+
+prof_jn:
+    profile->executions[pc]++;
+    profile->instructions[9]++;
+    if (ac & 0x80) profile->taken[pc]++;
+    else profile->not_taken[pc]++;
+    goto op_jn;
+
+prof_jz:
+    profile->executions[pc]++;
+    profile->instructions[10]++;
+    if (ac == 0) profile->taken[pc]++;
+    else profile->not_taken[pc]++;
+    goto op_jz;
+
+prof_hlt:
+    profile->executions[pc]++;
+    profile->instructions[15]++;
+
+op_hlt:
+    steps++;
+
+finish:
+    if (trace) {
+        trace->cursor = trace_cursor;
+    }
+    neander->ac = ac;
+    neander->pc = pc;
+    neander->steps = steps;
+    if (executed) {
+        neander->z = (flags_ac == 0);
+        neander->n = (flags_ac & 0x80) != 0;
+    }
+
+    return status;
+}
@@ -15,7 +15,48 @@
 #define JZ 0xA0
 #define HLT 0xF0
 
-#define MEMORY_SIZE 516
+#define MEMORY_SIZE 256   // Memória nativa: um byte por endereço
+#define FILE_HEADER_SIZE 4
+#define FILE_SIZE (FILE_HEADER_SIZE + MEMORY_SIZE * 2) // .mem: palavras de 16 bits LE
+#define DUMP_SIZE FILE_SIZE
+
+extern const uint8_t file_id[FILE_HEADER_SIZE]; // Cabeçalho do .mem
+
+// .nex, o executável pré-decodificado do montador: cabeçalho, a mesma
+// imagem de 16 bits do .mem (256 palavras), o número de instruções
+// (16 bits LE) e um registro de 4 bytes por instrução: endereço, opcode,
+// operando e flags
+#define NEX_COUNT_OFFSET (FILE_HEADER_SIZE + MEMORY_SIZE * 2)
+#define NEX_RECORDS_OFFSET (NEX_COUNT_OFFSET + 2)
+#define NEX_RECORD_SIZE 4
+#define NEX_OPERAND 0x01  // Instrução de 2 bytes
+#define NEX_LEADER 0x02   // Começo de bloco básico
+
+extern const uint8_t nex_id[FILE_HEADER_SIZE]; // Cabeçalho do .nex
+
+typedef struct Profile Profile;
+typedef struct Trace Trace;
+typedef struct Watchdog Watchdog;
+
+typedef enum {
+    NEANDER_OK = 0,       // Carregado, ou executou até o HLT
+    NEANDER_ERROR_OPEN,   // Não foi possível abrir ou mapear o arquivo
+    NEANDER_ERROR_FORMAT, // Cabeçalho do .mem ou .nex inválido
+    NEANDER_LOOP,         // O watchdog encontrou um estado repetido
+    NEANDER_BUDGET        // O watchdog parou no limite de instruções
+} NeanderStatus;
+
+// Instrução pré-decodificada para um endereço. As superinstruções
+// (LDA;STA, LDA;ADD;STA e LDA;NOT;ADD;STA) usam também operand e store;
+// o laço de multiplicação usa todos os campos.
+typedef struct {
+    const void *handler; // Rótulo do motor em run()
+    uint8_t address;     // Endereço do operando
+    uint8_t operand;     // Operando do ADD de uma superinstrução
+    uint8_t store;       // Endereço do STA de uma superinstrução
+    uint8_t decrement;   // Constante -1 do laço de multiplicação
+    uint8_t exit;        // Destino do JZ do laço de multiplicação
+} DecodedInstr;
 
 typedef struct {
     uint8_t ac;          // Acumulador
@@ -23,10 +64,22 @@ typedef struct {
     bool z;              // Flag Zero
     bool n;              // Flag Negative
     uint8_t memory[MEMORY_SIZE]; // Memória
+    uint8_t high[MEMORY_SIZE];   // Byte alto de cada palavra do .mem, só para o dump
+    DecodedInstr code[MEMORY_SIZE]; // Instruções pré-decodificadas
+    uint8_t decoded[MEMORY_SIZE]; // Do .nex: índice no dispatch + 1 em cada instrução, 0 fora do código
+    bool leader[MEMORY_SIZE];     // Do .nex: começos de bloco básico
+    bool predecoded;     // decoded e leader valem para a memória atual
+    uint64_t steps;      // Instruções executadas por run(), incluindo o HLT
+    Profile *profile;    // Contadores de perfil, NULL se desativado
+    Trace *trace;        // Trace da execução, NULL se desativado
+    Watchdog *watchdog;  // Detecção de laço infinito, NULL se desativada
 } Neander;
 
 void init_neander(Neander *neander);
-void print_memory(const Neander *neander);
-int run(Neander *neander);
+NeanderStatus load_neander(Neander *neander, const char *filename);
+const char *neander_status_string(NeanderStatus status);
+const char *opcode_name(uint8_t opcode);
+uint32_t memory_hash(const Neander *neander);
+NeanderStatus run(Neander *neander);
 
 #endif // NEANDER_H
\ No newline at end of file
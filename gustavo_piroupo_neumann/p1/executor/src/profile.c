@@ -0,0 +1,164 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "profile.h"
+
+typedef struct {
+    uint8_t address;
+    uint64_t count;
+} HotSpot;
+
+// Acessos por classe: opcode, endereço do operando e dado. JN e JZ só
+// buscam o endereço quando desviam; NOT, HLT e NOP só buscam o opcode.
+static const uint8_t cycle_model[16][3] = {
+    [0x1] = {1, 1, 1}, // STA: escreve o AC
+    [0x2] = {1, 1, 1}, // LDA
+    [0x3] = {1, 1, 1}, // ADD
+    [0x4] = {1, 1, 1}, // OR
+    [0x5] = {1, 1, 1}, // AND
+    [0x8] = {1, 1, 0}, // JMP
+    [0x9] = {1, 0, 0}, // JN, mais o endereço se desviar
+    [0xA] = {1, 0, 0}, // JZ, idem
+    [0x0] = {1, 0, 0}, [0x6] = {1, 0, 0}, [0xF] = {1, 0, 0},
+};
+
+void init_profile(Profile *profile) {
+    memset(profile, 0, sizeof(Profile));
+}
+
+// Mais executados primeiro; empate pelo menor endereço
+static int compare_hot_spots(const void *a, const void *b) {
+    const HotSpot *x = a;
+    const HotSpot *y = b;
+
+    if (x->count != y->count) {
+        return (x->count < y->count) ? 1 : -1;
+    }
+    return (int)x->address - (int)y->address;
+}
+
+// Copia os endereços com contagem não nula e ordena
+static int collect(HotSpot spots[MEMORY_SIZE], const uint64_t *a, const uint64_t *b) {
+    int count = 0;
+
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        uint64_t total = a[i] + (b ? b[i] : 0);
+        if (total) {
+            spots[count].address = (uint8_t)i;
+            spots[count].count = total;
+            count++;
+        }
+    }
+
+    qsort(spots, count, sizeof(HotSpot), compare_hot_spots);
+    return count;
+}
+
+// Relatório de pontos quentes
+void print_profile(const Profile *profile, const Neander *neander, FILE *output) {
+    HotSpot spots[MEMORY_SIZE];
+    uint64_t steps = 0;
+
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        steps += profile->executions[i];
+    }
+
+    fprintf(output, "Profile: %llu steps\n", (unsigned long long)steps);
+
+    fprintf(output, "\nHot spots:\n");
+    fprintf(output, "  addr  instr        count      %%\n");
+    int count = collect(spots, profile->executions, NULL);
+    for (int i = 0; i < count && i < PROFILE_TOP; i++) {
+        uint8_t address = spots[i].address;
+        uint8_t opcode = neander->memory[address];
+        const char *name = opcode_name(opcode);
+        char instr[16];
+
+        if (opcode == NOT || opcode == HLT) {
+            snprintf(instr, sizeof(instr), "%s", name);
+        } else {
+            snprintf(instr, sizeof(instr), "%s 0x%02X", name, neander->memory[(uint8_t)(address + 1)]);
+        }
+
+        fprintf(output, "  0x%02X  %-9s %8llu  %5.1f\n", address, instr,
+                (unsigned long long)spots[i].count, 100.0 * spots[i].count / steps);
+    }
+
+    fprintf(output, "\nBranches:\n");
+    fprintf(output, "  addr  instr        taken  not taken\n");
+    count = collect(spots, profile->taken, profile->not_taken);
+    for (int i = 0; i < count && i < PROFILE_TOP; i++) {
+        uint8_t address = spots[i].address;
+        char instr[16];
+
+        snprintf(instr, sizeof(instr), "%s 0x%02X", opcode_name(neander->memory[address]),
+                 neander->memory[(uint8_t)(address + 1)]);
+        fprintf(output, "  0x%02X  %-9s %8llu  %9llu\n", address, instr,
+                (unsigned long long)profile->taken[address],
+                (unsigned long long)profile->not_taken[address]);
+    }
+
+    fprintf(output, "\nMemory:\n");
+    fprintf(output, "  addr     reads   writes\n");
+    count = collect(spots, profile->reads, profile->writes);
+    for (int i = 0; i < count && i < PROFILE_TOP; i++) {
+        uint8_t address = spots[i].address;
+        fprintf(output, "  0x%02X  %8llu %8llu\n", address,
+                (unsigned long long)profile->reads[address],
+                (unsigned long long)profile->writes[address]);
+    }
+}
+
+void count_cycles(const Profile *profile, Cycles *cycles) {
+    memset(cycles, 0, sizeof(Cycles));
+
+    for (int i = 0; i < 16; i++) {
+        cycles->fetch += profile->instructions[i] * cycle_model[i][0];
+        cycles->operand += profile->instructions[i] * cycle_model[i][1];
+        cycles->data += profile->instructions[i] * cycle_model[i][2];
+    }
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        cycles->operand += profile->taken[i];
+    }
+}
+
+// Custo modelado, independente da máquina hospedeira
+void print_cycles(const Profile *profile, FILE *output) {
+    Cycles cycles;
+    uint64_t steps = 0;
+
+    count_cycles(profile, &cycles);
+    for (int i = 0; i < 16; i++) {
+        steps += profile->instructions[i];
+    }
+
+    uint64_t total = cycles.fetch + cycles.operand + cycles.data;
+    fprintf(output, "Cycles: %llu (fetch %llu, operand %llu, data %llu), %llu instructions",
+            (unsigned long long)total, (unsigned long long)cycles.fetch,
+            (unsigned long long)cycles.operand, (unsigned long long)cycles.data,
+            (unsigned long long)steps);
+    if (steps) {
+        fprintf(output, ", %.2f cycles/instruction", (double)total / steps);
+    }
+    fprintf(output, "\n");
+
+    uint64_t taken = 0;
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        taken += profile->taken[i];
+    }
+
+    fprintf(output, "\n  instr       count     cycles\n");
+    for (int i = 0; i < 16; i++) {
+        if (profile->instructions[i] == 0) continue;
+
+        uint64_t count = profile->instructions[i];
+        uint64_t cost = count * (cycle_model[i][0] + cycle_model[i][1] + cycle_model[i][2]);
+        fprintf(output, "  %-3s  %12llu %10llu\n", opcode_name((uint8_t)(i << 4)),
+                (unsigned long long)count, (unsigned long long)cost);
+    }
+    // Endereço buscado pelos JN/JZ que desviaram
+    if (taken) {
+        fprintf(output, "  taken%12llu %10llu\n", (unsigned long long)taken,
+                (unsigned long long)taken);
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "neander.h"
+
+#define PROFILE_TOP 16   // Linhas por seção do relatório
+
+// Contadores por endereço, preenchidos por run() quando neander->profile != NULL
+struct Profile {
+    uint64_t executions[MEMORY_SIZE]; // Execuções da instrução no endereço
+    uint64_t taken[MEMORY_SIZE];      // JN/JZ que desviaram
+    uint64_t not_taken[MEMORY_SIZE];  // JN/JZ que seguiram em frente
+    uint64_t reads[MEMORY_SIZE];      // Leituras de dado no endereço
+    uint64_t writes[MEMORY_SIZE];     // Escritas de dado no endereço
+    uint64_t instructions[16];        // Execuções por opcode >> 4, desconhecidos em 0
+};
+
+// Custo modelado em acessos à memória do Neander, um ciclo cada: busca do
+// opcode, busca do endereço do operando e leitura ou escrita do dado
+typedef struct {
+    uint64_t fetch;
+    uint64_t operand;
+    uint64_t data;
+} Cycles;
+
+void init_profile(Profile *profile);
+void print_profile(const Profile *profile, const Neander *neander, FILE *output);
+void count_cycles(const Profile *profile, Cycles *cycles);
+void print_cycles(const Profile *profile, FILE *output);
+
+#endif // PROFILE_H
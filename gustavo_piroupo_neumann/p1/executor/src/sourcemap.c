@@ -0,0 +1,167 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "sourcemap.h"
+
+#define MAP_LINE_SIZE 4096
+
+// Passos de um comando ou de uma operação
+typedef struct {
+    int line;             // Linha do .lpn, ou do .asm sem mapa do compilador
+    bool lpn;
+    const char *text;     // NULL só nas linhas do .asm
+    uint64_t count;
+} SourceSpot;
+
+// Próximo campo separado por tabulação; os vazios valem
+static char *next_field(char **cursor) {
+    char *field = *cursor;
+    if (!field) return NULL;
+
+    char *tab = strchr(field, '\t');
+    if (tab) {
+        *tab = '\0';
+        *cursor = tab + 1;
+    } else {
+        *cursor = NULL;
+    }
+    return field;
+}
+
+bool sourcemap_load(SourceMap *map, const char *filename) {
+    memset(map, 0, sizeof(SourceMap));
+
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        return false;
+    }
+
+    char line[MAP_LINE_SIZE];
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == ';' || line[0] == '\0') continue;
+
+        char *cursor = line;
+        char *address = next_field(&cursor);
+        char *asm_line = next_field(&cursor);
+        char *lpn_line = next_field(&cursor);
+        char *statement = next_field(&cursor);
+        char *expression = next_field(&cursor);
+
+        unsigned long value = strtoul(address, NULL, 0);
+        if (!asm_line || value >= MEMORY_SIZE) continue;
+
+        // Uma seção .CODE posterior pode ter escrito no mesmo endereço
+        free(map->statement[value]);
+        free(map->expression[value]);
+        map->asm_line[value] = atoi(asm_line);
+        map->lpn_line[value] = lpn_line ? atoi(lpn_line) : 0;
+        map->statement[value] = (statement && *statement) ? strdup(statement) : NULL;
+        map->expression[value] = (expression && *expression) ? strdup(expression) : NULL;
+    }
+
+    fclose(file);
+    return true;
+}
+
+void sourcemap_free(SourceMap *map) {
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        free(map->statement[i]);
+        free(map->expression[i]);
+    }
+}
+
+// "line 5: z = x * y (x * y)", ou "asm line 14" sem o mapa do compilador
+void sourcemap_describe(const SourceMap *map, uint8_t address, char *text, size_t size) {
+    if (map->lpn_line[address] && map->statement[address]) {
+        int length = snprintf(text, size, "line %d: %s", map->lpn_line[address],
+                              map->statement[address]);
+        if (map->expression[address] && length >= 0 && (size_t)length < size) {
+            snprintf(text + length, size - length, " (%s)", map->expression[address]);
+        }
+    } else if (map->asm_line[address]) {
+        snprintf(text, size, "asm line %d", map->asm_line[address]);
+    } else {
+        snprintf(text, size, "?");
+    }
+}
+
+// Soma count no grupo de (line, text), criando se preciso
+static void add_spot(SourceSpot *spots, int *count, int line, bool lpn, const char *text,
+                     uint64_t steps) {
+    for (int i = 0; i < *count; i++) {
+        if (spots[i].line == line && spots[i].lpn == lpn &&
+            (spots[i].text == text || (spots[i].text && text && strcmp(spots[i].text, text) == 0))) {
+            spots[i].count += steps;
+            return;
+        }
+    }
+    spots[*count] = (SourceSpot){line, lpn, text, steps};
+    (*count)++;
+}
+
+static int compare_spots(const void *a, const void *b) {
+    const SourceSpot *x = a;
+    const SourceSpot *y = b;
+
+    if (x->count != y->count) {
+        return (x->count < y->count) ? 1 : -1;
+    }
+    return x->line - y->line;
+}
+
+static void print_spots(SourceSpot *spots, int count, uint64_t steps, FILE *output) {
+    qsort(spots, count, sizeof(SourceSpot), compare_spots);
+
+    for (int i = 0; i < count; i++) {
+        if (spots[i].lpn) {
+            fprintf(output, "  `%s`, line %d", spots[i].text, spots[i].line);
+        } else {
+            fprintf(output, "  asm line %d", spots[i].line);
+        }
+        fprintf(output, ": %.1f%% of steps (%llu)\n", 100.0 * spots[i].count / steps,
+                (unsigned long long)spots[i].count);
+    }
+}
+
+// Passos por comando do .lpn e por operação dentro dos comandos
+void print_source_profile(const SourceMap *map, const uint64_t executions[MEMORY_SIZE], FILE *output) {
+    SourceSpot statements[MEMORY_SIZE];
+    SourceSpot expressions[MEMORY_SIZE];
+    int statement_count = 0;
+    int expression_count = 0;
+    uint64_t steps = 0;
+    uint64_t unmapped = 0;
+
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        if (executions[i] == 0) continue;
+        steps += executions[i];
+
+        if (map->lpn_line[i] && map->statement[i]) {
+            add_spot(statements, &statement_count, map->lpn_line[i], true, map->statement[i],
+                     executions[i]);
+            if (map->expression[i]) {
+                add_spot(expressions, &expression_count, map->lpn_line[i], true,
+                         map->expression[i], executions[i]);
+            }
+        } else if (map->asm_line[i]) {
+            add_spot(statements, &statement_count, map->asm_line[i], false, NULL, executions[i]);
+        } else {
+            unmapped += executions[i];
+        }
+    }
+
+    if (steps == 0) return;
+
+    fprintf(output, "\nSource:\n");
+    print_spots(statements, statement_count, steps, output);
+    if (unmapped) {
+        fprintf(output, "  not in the map: %.1f%% of steps (%llu)\n", 100.0 * unmapped / steps,
+                (unsigned long long)unmapped);
+    }
+
+    if (expression_count) {
+        fprintf(output, "\nOperations:\n");
+        print_spots(expressions, expression_count, steps, output);
+    }
+}
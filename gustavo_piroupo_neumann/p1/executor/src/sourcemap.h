@@ -0,0 +1,33 @@
+#ifndef SOURCEMAP_H
+#define SOURCEMAP_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "neander.h"
+
+/*
+ * Mapa de fontes gravado por assembler -g: uma linha por instrução, com
+ * campos separados por tabulação
+ *
+ *   0xNN  linha do .asm  linha do .lpn  comando  operação
+ *
+ * Os três últimos vêm do mapa de compilador -g; sem ele a linha do .lpn
+ * é 0. A operação é o trecho do comando que gerou a instrução (x * y em
+ * z = x * y), vazia se a instrução é do comando todo. Linhas com ';' são
+ * comentários.
+ */
+
+typedef struct {
+    int asm_line[MEMORY_SIZE];      // 0: endereço sem instrução no mapa
+    int lpn_line[MEMORY_SIZE];      // 0: sem mapa do compilador
+    char *statement[MEMORY_SIZE];
+    char *expression[MEMORY_SIZE];  // NULL se a instrução é do comando todo
+} SourceMap;
+
+bool sourcemap_load(SourceMap *map, const char *filename);
+void sourcemap_free(SourceMap *map);
+void sourcemap_describe(const SourceMap *map, uint8_t address, char *text, size_t size);
+void print_source_profile(const SourceMap *map, const uint64_t executions[MEMORY_SIZE], FILE *output);
+
+#endif // SOURCEMAP_H
@@ -0,0 +1,367 @@
+#include <stdlib.h>
+
+#include "neander.h"
+
+// Varredura de parâmetros: o mesmo programa com várias memórias iniciais,
+// SWEEP_LANES máquinas em lockstep. A memória fica em estrutura de arrays
+// (uma linha por endereço, um byte por lane), então LDA/ADD/STA viram
+// operações vetoriais sobre uma linha. Os vetores usam a extensão do GCC
+// e viram SSE2, ou AVX2 com -mavx2.
+
+#ifndef SWEEP_LANES
+#define SWEEP_LANES 32 // 16, 32 ou 64
+#endif
+
+#define SWEEP_WORDS (SWEEP_LANES / 8)
+// Grupos menores que isso rodam lane a lane no interpretador
+#define SWEEP_MIN_LANES (SWEEP_LANES / 8)
+
+typedef uint8_t LaneVector __attribute__((vector_size(SWEEP_LANES)));
+typedef int8_t LaneMask __attribute__((vector_size(SWEEP_LANES)));
+
+_Static_assert(SWEEP_LANES == 16 || SWEEP_LANES == 32 || SWEEP_LANES == 64,
+               "SWEEP_LANES deve ser 16, 32 ou 64");
+
+typedef enum {
+    LANE_UNUSED,
+    LANE_WAITING,   // Parada em pc, esperando um grupo
+    LANE_DONE       // Chegou ao HLT
+} LaneState;
+
+typedef struct {
+    LaneVector memory[MEMORY_SIZE]; // memory[endereço][lane]
+    LaneVector ac;
+    LaneVector flags_ac;            // AC antes da última instrução
+    uint8_t pc[SWEEP_LANES];
+    bool executed[SWEEP_LANES];
+    bool z[SWEEP_LANES];
+    bool n[SWEEP_LANES];
+    LaneState state[SWEEP_LANES];
+    uint64_t vector_steps;          // Instruções executadas em lockstep
+    uint64_t scalar_lanes;          // Lanes terminadas no interpretador
+} Sweep;
+
+// Resultado de um .mem, no mesmo formato do batch
+typedef struct {
+    NeanderStatus status;
+    uint8_t ac;
+    uint8_t pc;
+    bool z;
+    bool n;
+    uint32_t memory_hash;
+} SweepResult;
+
+static LaneVector blend(LaneMask mask, LaneVector if_set, LaneVector if_clear) {
+    return (if_set & (LaneVector)mask) | (if_clear & ~(LaneVector)mask);
+}
+
+static int count_lanes(LaneMask mask) {
+    uint64_t words[SWEEP_WORDS];
+    int count = 0;
+
+    memcpy(words, &mask, sizeof(words));
+    for (int i = 0; i < SWEEP_WORDS; i++) {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count / 8;
+}
+
+static bool any_lane(LaneMask mask) {
+    uint64_t words[SWEEP_WORDS];
+    uint64_t any = 0;
+
+    memcpy(words, &mask, sizeof(words));
+    for (int i = 0; i < SWEEP_WORDS; i++) {
+        any |= words[i];
+    }
+    return any != 0;
+}
+
+// Todas as lanes ativas têm o mesmo byte nesta linha?
+static bool uniform_row(LaneVector row, LaneMask active, int lane) {
+    LaneVector same = row - row[lane];
+    return !any_lane((LaneMask)same & active);
+}
+
+static void sweep_load_lane(Sweep *sweep, int lane, const Neander *neander) {
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        sweep->memory[i][lane] = neander->memory[i];
+    }
+    sweep->ac[lane] = neander->ac;
+    sweep->flags_ac[lane] = neander->ac;
+    sweep->pc[lane] = neander->pc;
+    sweep->executed[lane] = neander->memory[neander->pc] != HLT;
+    sweep->state[lane] = LANE_WAITING;
+}
+
+static void sweep_finish_lane(Sweep *sweep, int lane) {
+    if (sweep->executed[lane]) {
+        sweep->z[lane] = sweep->flags_ac[lane] == 0;
+        sweep->n[lane] = (sweep->flags_ac[lane] & 0x80) != 0;
+    }
+    sweep->state[lane] = LANE_DONE;
+}
+
+// Termina as lanes do grupo no interpretador, uma de cada vez
+static void run_scalar(Sweep *sweep, LaneMask active, uint8_t pc) {
+    Neander neander;
+
+    for (int lane = 0; lane < SWEEP_LANES; lane++) {
+        if (!active[lane]) continue;
+
+        init_neander(&neander);
+        for (int i = 0; i < MEMORY_SIZE; i++) {
+            neander.memory[i] = sweep->memory[i][lane];
+        }
+        neander.ac = sweep->ac[lane];
+        neander.pc = pc;
+        // Se a lane já executou algo, os flags atuais valem até run()
+        // executar a próxima instrução
+        if (sweep->executed[lane]) {
+            neander.z = sweep->flags_ac[lane] == 0;
+            neander.n = (sweep->flags_ac[lane] & 0x80) != 0;
+        }
+
+        run(&neander);
+
+        for (int i = 0; i < MEMORY_SIZE; i++) {
+            sweep->memory[i][lane] = neander.memory[i];
+        }
+        sweep->ac[lane] = neander.ac;
+        sweep->pc[lane] = neander.pc;
+        sweep->z[lane] = neander.z;
+        sweep->n[lane] = neander.n;
+        sweep->state[lane] = LANE_DONE;
+        sweep->scalar_lanes++;
+    }
+}
+
+// Tira do grupo as lanes de leaving, que esperam em pc
+static void park(Sweep *sweep, LaneMask leaving, uint8_t pc, LaneVector ac, LaneVector flags_ac) {
+    sweep->ac = blend(leaving, ac, sweep->ac);
+    sweep->flags_ac = blend(leaving, flags_ac, sweep->flags_ac);
+    for (int lane = 0; lane < SWEEP_LANES; lane++) {
+        if (leaving[lane]) {
+            sweep->pc[lane] = pc;
+            sweep->state[lane] = LANE_WAITING;
+        }
+    }
+}
+
+// Executa em lockstep as lanes de active, todas em pc, até o HLT. Num
+// JN/JZ divergente, o lado com mais lanes segue e o outro espera.
+static void run_group(Sweep *sweep, LaneMask active, uint8_t pc) {
+    LaneVector *memory = sweep->memory;
+    LaneVector ac = sweep->ac;
+    LaneVector flags_ac = sweep->flags_ac;
+    int lanes = count_lanes(active);
+    int first = 0;
+    // Linha conferida como igual em todas as lanes do grupo desde o último STA
+    bool uniform[MEMORY_SIZE] = {false};
+
+    while (!active[first]) first++;
+
+    for (;;) {
+        if (lanes < SWEEP_MIN_LANES) break;
+
+        uint8_t next = (uint8_t)(pc + 1);
+        // O código é lido da memória de cada lane: só segue em lockstep se
+        // o opcode e o operando forem iguais em todas
+        if (!uniform[pc]) {
+            if (!uniform_row(memory[pc], active, first)) break;
+            uniform[pc] = true;
+        }
+
+        uint8_t opcode = memory[pc][first];
+        if (opcode != NOT && opcode != HLT && !uniform[next]) {
+            if (!uniform_row(memory[next], active, first)) break;
+            uniform[next] = true;
+        }
+
+        uint8_t address = memory[next][first];
+        LaneVector value = memory[address];
+
+        if (opcode == HLT) {
+            sweep->ac = blend(active, ac, sweep->ac);
+            sweep->flags_ac = blend(active, flags_ac, sweep->flags_ac);
+            for (int lane = 0; lane < SWEEP_LANES; lane++) {
+                if (!active[lane]) continue;
+                sweep->pc[lane] = pc;
+                sweep_finish_lane(sweep, lane);
+            }
+            return;
+        }
+
+        sweep->vector_steps++;
+        flags_ac = blend(active, ac, flags_ac);
+
+        switch ((opcode & 0x0F) ? 0 : opcode >> 4) {
+            case STA >> 4:
+                memory[address] = blend(active, ac, value);
+                uniform[address] = false;
+                pc += 2;
+                break;
+            case LDA >> 4:
+                ac = blend(active, value, ac);
+                pc += 2;
+                break;
+            case ADD >> 4:
+                ac = blend(active, ac + value, ac);
+                pc += 2;
+                break;
+            case 0x4:
+                ac = blend(active, ac | value, ac);
+                pc += 2;
+                break;
+            case 0x5:
+                ac = blend(active, ac & value, ac);
+                pc += 2;
+                break;
+            case NOT >> 4:
+                ac = blend(active, ~ac, ac);
+                pc += 1;
+                break;
+            case JMP >> 4:
+                pc = address;
+                break;
+            case JN >> 4:
+            case JZ >> 4: {
+                LaneMask condition = (opcode == JN) ? ((LaneMask)ac < 0) : (LaneMask)(ac == 0);
+                LaneMask taken = condition & active;
+                LaneMask not_taken = ~condition & active;
+                int taken_lanes = count_lanes(taken);
+                uint8_t fall = (uint8_t)(pc + 2);
+
+                if (taken_lanes == lanes) {
+                    pc = address;
+                } else if (taken_lanes == 0) {
+                    pc = fall;
+                } else if (taken_lanes * 2 >= lanes) {
+                    park(sweep, not_taken, fall, ac, flags_ac);
+                    active = taken;
+                    lanes = taken_lanes;
+                    pc = address;
+                } else {
+                    park(sweep, taken, address, ac, flags_ac);
+                    active = not_taken;
+                    lanes -= taken_lanes;
+                    pc = fall;
+                }
+
+                // O grupo só encolhe, então as linhas conferidas continuam iguais
+                while (!active[first]) first++;
+                break;
+            }
+            default:
+                pc += 2;
+                break;
+        }
+    }
+
+    // Poucas lanes ou código diferente entre elas: interpretador
+    sweep->ac = blend(active, ac, sweep->ac);
+    sweep->flags_ac = blend(active, flags_ac, sweep->flags_ac);
+    run_scalar(sweep, active, pc);
+}
+
+// Forma grupos com as lanes que esperam no mesmo pc até todas terminarem
+static void sweep_run(Sweep *sweep) {
+    for (;;) {
+        int leader = -1;
+        for (int lane = 0; lane < SWEEP_LANES; lane++) {
+            if (sweep->state[lane] == LANE_WAITING) {
+                leader = lane;
+                break;
+            }
+        }
+        if (leader < 0) return;
+
+        uint8_t pc = sweep->pc[leader];
+        LaneMask active = {0};
+        for (int lane = leader; lane < SWEEP_LANES; lane++) {
+            if (sweep->state[lane] == LANE_WAITING && sweep->pc[lane] == pc) {
+                active[lane] = -1;
+            }
+        }
+
+        run_group(sweep, active, pc);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s [file.mem ...]\n", argv[0]);
+        return 1;
+    }
+
+    int count = argc - 1;
+    char **files = argv + 1;
+    SweepResult *results = calloc(count, sizeof(SweepResult));
+    Sweep *sweep = aligned_alloc(_Alignof(Sweep), sizeof(Sweep)); // Vetores de até 64 bytes
+    Neander *neander = malloc(sizeof(Neander));
+    int lane_of[SWEEP_LANES];
+    uint64_t vector_steps = 0;
+    uint64_t scalar_lanes = 0;
+
+    if (!results || !sweep || !neander) {
+        fprintf(stderr, "Error: out of memory\n");
+        return 1;
+    }
+
+    // Até SWEEP_LANES arquivos por rodada
+    for (int start = 0; start < count; start += SWEEP_LANES) {
+        int loaded = 0;
+        memset(sweep, 0, sizeof(Sweep));
+
+        for (int job = start; job < count && job < start + SWEEP_LANES; job++) {
+            init_neander(neander);
+            results[job].status = load_neander(neander, files[job]);
+            if (results[job].status != NEANDER_OK) continue;
+
+            lane_of[loaded] = job;
+            sweep_load_lane(sweep, loaded, neander);
+            loaded++;
+        }
+
+        sweep_run(sweep);
+        vector_steps += sweep->vector_steps;
+        scalar_lanes += sweep->scalar_lanes;
+
+        for (int lane = 0; lane < loaded; lane++) {
+            SweepResult *result = &results[lane_of[lane]];
+
+            for (int i = 0; i < MEMORY_SIZE; i++) {
+                neander->memory[i] = sweep->memory[i][lane];
+            }
+            result->ac = sweep->ac[lane];
+            result->pc = sweep->pc[lane];
+            result->z = sweep->z[lane];
+            result->n = sweep->n[lane];
+            result->memory_hash = memory_hash(neander);
+        }
+    }
+
+    // Uma linha por arquivo, como no batch
+    int failed = 0;
+    for (int i = 0; i < count; i++) {
+        SweepResult *result = &results[i];
+
+        if (result->status != NEANDER_OK) {
+            printf("%s error %s\n", files[i], neander_status_string(result->status));
+            failed++;
+            continue;
+        }
+
+        printf("%s ok ac=%03d pc=%03d z=%d n=%d mem=%08x\n", files[i],
+               result->ac, result->pc, result->z, result->n, result->memory_hash);
+    }
+
+    fprintf(stderr, "%d jobs, %d failed, %d lanes, %llu vector steps, %llu lanes in the interpreter\n",
+            count, failed, SWEEP_LANES, (unsigned long long)vector_steps,
+            (unsigned long long)scalar_lanes);
+
+    free(results);
+    free(sweep);
+    free(neander);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,211 @@
+#include <errno.h>
+#include <stdlib.h>
+
+#include "trace.h"
+
+static const uint8_t trace_magic[4] = {'N', 'T', 'R', 'C'};
+
+static void write_le(FILE *file, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        putc((int)((value >> (8 * i)) & 0xFF), file);
+    }
+}
+
+static void start_chunk(Trace *trace) {
+    trace->length = 0;
+    trace->chunk_step = trace->encoded_step;
+    trace->next_pc = -1; // Força pc e AC explícitos na primeira entrada
+    trace->ac = -1;
+}
+
+static void write_chunk(Trace *trace) {
+    if (trace->length == 0) return;
+    write_le(trace->file, trace->length, 4);
+    write_le(trace->file, trace->chunk_step, 8);
+    fwrite(trace->chunk, 1, trace->length, trace->file);
+}
+
+// Codifica count registros em delta, gravando cada bloco que enche. Os
+// bytes opcionais são sempre escritos e o cursor só avança sobre os usados.
+static void encode(Trace *trace, const TraceRecord *records, size_t count) {
+    while (count > 0) {
+        size_t room = (TRACE_CHUNK_SIZE - trace->length) / TRACE_ENTRY_MAX;
+        if (room == 0) {
+            write_chunk(trace);
+            start_chunk(trace);
+            continue;
+        }
+        size_t n = count < room ? count : room;
+
+        uint8_t *p = trace->chunk + trace->length;
+        int next_pc = trace->next_pc;
+        int last_ac = trace->ac;
+
+        for (size_t i = 0; i < n; i++) {
+            TraceRecord record = records[i];
+            uint8_t pc = (uint8_t)record;
+            uint8_t opcode = (uint8_t)(record >> 8);
+            uint8_t ac = (uint8_t)(record >> 16);
+            uint8_t address = (uint8_t)(record >> 24);
+
+            uint8_t *entry = p++;
+            unsigned raw = (opcode & 0x0F) != 0;
+            unsigned jumped = pc != next_pc;
+            unsigned changed = ac != last_ac;
+            unsigned write = opcode == STA;
+
+            next_pc = (uint8_t)(pc + (opcode == NOT ? 1 : 2));
+            last_ac = ac;
+
+            *p = opcode;
+            p += raw;
+            *p = pc;
+            p += jumped;
+            *p = ac;
+            p += changed;
+            *p = address;
+            p += write;
+            *entry = (uint8_t)((opcode & 0xF0) | raw << 3 | write << 2 | changed << 1 | jumped);
+        }
+
+        trace->length = (size_t)(p - trace->chunk);
+        trace->next_pc = next_pc;
+        trace->ac = last_ac;
+        trace->encoded_step += n;
+        records += n;
+        count -= n;
+    }
+}
+
+// Codifica e grava cada lote entregue por trace_flush. Ao parar, termina
+// antes o lote pendente.
+static void *write_batches(void *arg) {
+    Trace *trace = arg;
+
+    pthread_mutex_lock(&trace->lock);
+    for (;;) {
+        while (trace->pending == 0 && !trace->stop) {
+            pthread_cond_wait(&trace->cond, &trace->lock);
+        }
+        if (trace->pending == 0) break;
+
+        size_t count = trace->pending;
+        pthread_mutex_unlock(&trace->lock);
+        encode(trace, trace->spare, count);
+        pthread_mutex_lock(&trace->lock);
+        trace->pending = 0;
+        pthread_cond_signal(&trace->cond);
+    }
+    pthread_mutex_unlock(&trace->lock);
+    return NULL;
+}
+
+bool trace_open(Trace *trace, const char *filename, size_t ring_records) {
+    size_t count = ring_records ? ring_records : TRACE_BATCH;
+
+    memset(trace, 0, sizeof(Trace));
+    trace->ring_size = ring_records;
+    trace->file = fopen(filename, "wb");
+    if (!trace->file) {
+        return false;
+    }
+
+    trace->records = malloc(count * sizeof(TraceRecord));
+    trace->chunk = malloc(TRACE_CHUNK_SIZE);
+    if (ring_records == 0) {
+        trace->spare = malloc(count * sizeof(TraceRecord));
+    }
+    if (!trace->records || !trace->chunk || (ring_records == 0 && !trace->spare)) {
+        trace_close(trace);
+        return false;
+    }
+
+    fwrite(trace_magic, 1, sizeof(trace_magic), trace->file);
+    putc(TRACE_VERSION, trace->file);
+
+    trace->cursor = trace->records;
+    trace->limit = trace->records + count;
+    start_chunk(trace);
+
+    if (ring_records == 0) {
+        pthread_mutex_init(&trace->lock, NULL);
+        pthread_cond_init(&trace->cond, NULL);
+        int error = pthread_create(&trace->writer, NULL, write_batches, trace);
+        if (error != 0) {
+            pthread_mutex_destroy(&trace->lock);
+            pthread_cond_destroy(&trace->cond);
+            trace_close(trace);
+            errno = error;
+            return false;
+        }
+        trace->writing = true;
+    }
+    return true;
+}
+
+// O lote encheu: no modo arquivo ele vai para a thread de escrita e run()
+// continua no outro, no modo anel os próximos registros sobrescrevem os
+// mais antigos
+TraceRecord *trace_flush(Trace *trace) {
+    size_t count = (size_t)(trace->limit - trace->records);
+
+    if (trace->ring_size == 0) {
+        pthread_mutex_lock(&trace->lock);
+        while (trace->pending != 0) {
+            pthread_cond_wait(&trace->cond, &trace->lock);
+        }
+        TraceRecord *full = trace->records;
+        trace->records = trace->spare;
+        trace->spare = full;
+        trace->pending = count;
+        pthread_cond_signal(&trace->cond);
+        pthread_mutex_unlock(&trace->lock);
+        trace->limit = trace->records + count;
+    } else {
+        trace->wrapped = true;
+    }
+    trace->steps += count;
+    trace->cursor = trace->records;
+    return trace->cursor;
+}
+
+bool trace_close(Trace *trace) {
+    bool ok = true;
+
+    if (trace->writing) {
+        pthread_mutex_lock(&trace->lock);
+        trace->stop = true;
+        pthread_cond_signal(&trace->cond);
+        pthread_mutex_unlock(&trace->lock);
+        pthread_join(trace->writer, NULL);
+        pthread_mutex_destroy(&trace->lock);
+        pthread_cond_destroy(&trace->cond);
+    }
+
+    if (trace->file && trace->cursor) {
+        size_t used = (size_t)(trace->cursor - trace->records);
+
+        if (trace->ring_size == 0) {
+            encode(trace, trace->records, used);
+        } else {
+            // Do mais antigo ao atual: depois do cursor ficam os registros
+            // da volta anterior
+            size_t older = trace->wrapped ? trace->ring_size - used : 0;
+            trace->encoded_step = trace->steps - older;
+            start_chunk(trace);
+            encode(trace, trace->cursor, older);
+            encode(trace, trace->records, used);
+        }
+        write_chunk(trace);
+    }
+
+    if (trace->file && fclose(trace->file) != 0) {
+        ok = false;
+    }
+
+    free(trace->records);
+    free(trace->spare);
+    free(trace->chunk);
+    memset(trace, 0, sizeof(Trace));
+    return ok;
+}
@@ -0,0 +1,94 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "neander.h"
+
+/*
+ * Trace binário da execução, uma entrada por instrução executada, com o
+ * estado de antes da instrução.
+ *
+ * Arquivo, inteiros em little-endian:
+ *
+ *   "NTRC"  magic
+ *   u8      versão (TRACE_VERSION)
+ *   repetido para cada bloco:
+ *     u32   tamanho do bloco em bytes
+ *     u64   número do primeiro passo do bloco
+ *     entradas
+ *
+ * Entrada:
+ *
+ *   u8  bits 7-4: opcode >> 4, bits 3-0: TRACE_* abaixo
+ *   u8  opcode completo, se TRACE_RAW
+ *   u8  pc, se TRACE_PC
+ *   u8  AC, se TRACE_AC
+ *   u8  endereço escrito (com o valor do AC), se TRACE_WRITE
+ *
+ * O pc só aparece quando não é o sucessor da entrada anterior e o AC só
+ * quando mudou. A primeira entrada de cada bloco tem pc e AC explícitos,
+ * então cada bloco pode ser lido sozinho.
+ *
+ * Durante a execução cada passo grava só um registro cru de tamanho fixo
+ * (pc, opcode, AC e endereço escrito). No modo arquivo, cada lote cheio
+ * vai para uma thread que faz a codificação em delta acima e grava o
+ * arquivo, enquanto o interpretador enche o outro lote.
+ */
+
+#define TRACE_VERSION 1
+#define TRACE_CHUNK_SIZE 65536  // Bytes por bloco
+#define TRACE_ENTRY_MAX 5       // Maior entrada possível
+#define TRACE_BATCH 16384       // Registros crus por lote no modo arquivo (dois lotes)
+
+#define TRACE_PC 0x01
+#define TRACE_AC 0x02
+#define TRACE_WRITE 0x04
+#define TRACE_RAW 0x08
+
+// Registro cru: byte 0 pc, 1 opcode, 2 AC, 3 endereço escrito
+typedef uint32_t TraceRecord;
+
+struct Trace {
+    FILE *file;
+    TraceRecord *records;   // O lote sendo preenchido, ou o anel no modo anel
+    TraceRecord *cursor;    // run() guarda o seu ao terminar
+    TraceRecord *limit;
+    size_t ring_size;       // Registros no anel; 0: grava tudo no arquivo
+    bool wrapped;           // O anel já deu a volta
+    uint64_t steps;         // Passos gravados antes de records[0]
+
+    // Thread de escrita do modo arquivo
+    TraceRecord *spare;     // O outro lote: livre, ou com a thread
+    size_t pending;         // Registros de spare ainda não codificados
+    bool writing;           // A thread está rodando
+    bool stop;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+
+    // Codificação dos blocos
+    uint8_t *chunk;
+    size_t length;
+    uint64_t chunk_step;    // Número do primeiro passo do bloco
+    uint64_t encoded_step;  // Próximo passo a codificar
+    int next_pc;            // Sucessor previsto da última entrada, -1 no início do bloco
+    int ac;                 // AC da última entrada, -1 no início do bloco
+};
+
+// ring_records == 0 grava o trace inteiro; senão guarda só os registros
+// dos últimos ring_records passos e grava no trace_close
+bool trace_open(Trace *trace, const char *filename, size_t ring_records);
+// Chamado por run() quando o lote enche; devolve o novo cursor, e limit
+// passa a ser o fim do novo lote
+TraceRecord *trace_flush(Trace *trace);
+bool trace_close(Trace *trace);
+
+// Registro de um passo, gravado por run() antes de executar a instrução
+#define TRACE_RECORD(pc, opcode, ac, address) \
+        ((TraceRecord)(pc) | (TraceRecord)(opcode) << 8 | (TraceRecord)(ac) << 16 | \
+         (TraceRecord)(address) << 24)
+
+#endif // TRACE_H
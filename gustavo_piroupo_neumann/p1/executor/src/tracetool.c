@@ -0,0 +1,259 @@
+#include <stdlib.h>
+#include <strings.h>
+
+#include "neander.h"
+#include "sourcemap.h"
+#include "trace.h"
+
+// Leitor offline dos traces gravados com executor -t: lista, filtra e resume
+
+typedef struct {
+    uint64_t step;
+    uint8_t pc;
+    uint8_t opcode;
+    uint8_t ac;            // AC antes da instrução
+    bool write;
+    uint8_t address;       // Endereço escrito, se write
+} TraceEntry;
+
+typedef struct {
+    int pc;                // -1: qualquer
+    int opcode;            // -1: qualquer; senão opcode >> 4
+    int write;             // -1: qualquer; senão endereço escrito
+    uint64_t from;
+    uint64_t to;
+} Filter;
+
+typedef struct {
+    uint64_t entries;
+    uint64_t omitted;      // Passos perdidos no anel
+    uint64_t first_step;
+    uint64_t last_step;
+    uint64_t bytes;
+    uint64_t opcodes[16];
+    uint64_t executions[MEMORY_SIZE];
+    uint64_t writes[MEMORY_SIZE];
+} Summary;
+
+static uint64_t read_le(const uint8_t *p, int bytes) {
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+static bool matches(const Filter *filter, const TraceEntry *entry) {
+    if (entry->step < filter->from || entry->step > filter->to) return false;
+    if (filter->pc >= 0 && entry->pc != filter->pc) return false;
+    if (filter->opcode >= 0 && ((entry->opcode & 0x0F) ? 0 : entry->opcode >> 4) != filter->opcode) {
+        return false;
+    }
+    if (filter->write >= 0 && (!entry->write || entry->address != filter->write)) return false;
+    return true;
+}
+
+// Com mapa de fontes, a linha termina com o comando da instrução
+static void print_entry(const TraceEntry *entry, const SourceMap *map) {
+    printf("%10llu  0x%02X  %-3s  ac=%03d", (unsigned long long)entry->step, entry->pc,
+           opcode_name(entry->opcode), entry->ac);
+    if (entry->write) {
+        printf("  [0x%02X] <- %03d", entry->address, entry->ac);
+    }
+    if (map) {
+        char source[256];
+        sourcemap_describe(map, entry->pc, source, sizeof(source));
+        printf("  ; %s", source);
+    }
+    printf("\n");
+}
+
+static void add_to_summary(Summary *summary, const TraceEntry *entry) {
+    if (summary->entries == 0) summary->first_step = entry->step;
+    summary->entries++;
+    summary->last_step = entry->step;
+    summary->opcodes[(entry->opcode & 0x0F) ? 0 : entry->opcode >> 4]++;
+    summary->executions[entry->pc]++;
+    if (entry->write) summary->writes[entry->address]++;
+}
+
+// Decodifica um bloco e devolve em *step o passo seguinte ao último;
+// devolve false se o bloco estiver truncado
+static bool replay_chunk(const uint8_t *data, size_t length, uint64_t *step,
+                         const Filter *filter, Summary *summary, bool listing,
+                         const SourceMap *map) {
+    const uint8_t *p = data;
+    const uint8_t *end = data + length;
+    TraceEntry entry = {0};
+    uint8_t next_pc = 0;
+
+    while (p < end) {
+        uint8_t tag = *p++;
+        size_t needed = ((tag & TRACE_RAW) != 0) + ((tag & TRACE_PC) != 0) +
+                        ((tag & TRACE_AC) != 0) + ((tag & TRACE_WRITE) != 0);
+        if ((size_t)(end - p) < needed) return false;
+
+        entry.step = (*step)++;
+        entry.opcode = (tag & TRACE_RAW) ? *p++ : (uint8_t)(tag & 0xF0);
+        entry.pc = (tag & TRACE_PC) ? *p++ : next_pc;
+        if (tag & TRACE_AC) entry.ac = *p++;
+        entry.write = (tag & TRACE_WRITE) != 0;
+        if (entry.write) entry.address = *p++;
+
+        next_pc = (uint8_t)(entry.pc + (entry.opcode == NOT ? 1 : 2));
+
+        if (!matches(filter, &entry)) continue;
+        add_to_summary(summary, &entry);
+        if (listing) print_entry(&entry, map);
+    }
+
+    return true;
+}
+
+static void print_summary(const Summary *summary, const SourceMap *map) {
+    printf("Trace: %llu entries", (unsigned long long)summary->entries);
+    if (summary->entries > 0) {
+        printf(" (steps %llu-%llu)", (unsigned long long)summary->first_step,
+               (unsigned long long)summary->last_step);
+    }
+    printf(", %llu bytes", (unsigned long long)summary->bytes);
+    if (summary->entries > 0) {
+        printf(", %.2f bytes/step", (double)summary->bytes / summary->entries);
+    }
+    printf("\n");
+    if (summary->omitted) {
+        printf("Omitted by the ring buffer: %llu steps\n", (unsigned long long)summary->omitted);
+    }
+
+    printf("\nInstructions:\n");
+    for (int i = 0; i < 16; i++) {
+        if (summary->opcodes[i] == 0) continue;
+        printf("  %-3s  %10llu\n", opcode_name((uint8_t)(i << 4)),
+               (unsigned long long)summary->opcodes[i]);
+    }
+
+    printf("\nAddresses:\n");
+    printf("  addr  executions     writes\n");
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        if (summary->executions[i] == 0 && summary->writes[i] == 0) continue;
+        printf("  0x%02X  %10llu %10llu\n", i, (unsigned long long)summary->executions[i],
+               (unsigned long long)summary->writes[i]);
+    }
+
+    if (map) {
+        print_source_profile(map, summary->executions, stdout);
+    }
+}
+
+static int parse_opcode(const char *name) {
+    static const char *const names[] = {"NOP", "STA", "LDA", "ADD", "OR", "AND", "NOT", NULL,
+                                        "JMP", "JN", "JZ", NULL, NULL, NULL, NULL, "HLT"};
+    for (int i = 0; i < 16; i++) {
+        if (names[i] && strcasecmp(name, names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+int main(int argc, char const *argv[]) {
+    const char *filename = NULL;
+    bool summarize = false;
+    Filter filter = {-1, -1, -1, 0, UINT64_MAX};
+    const char *map_filename = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0) {
+            summarize = true;
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            filter.pc = (int)strtol(argv[++i], NULL, 0) & 0xFF;
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            filter.opcode = parse_opcode(argv[++i]);
+            if (filter.opcode < 0) {
+                fprintf(stderr, "Error: unknown instruction '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            filter.write = (int)strtol(argv[++i], NULL, 0) & 0xFF;
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            filter.from = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            filter.to = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            map_filename = argv[++i];
+        } else {
+            filename = argv[i];
+        }
+    }
+
+    if (!filename) {
+        fprintf(stderr, "Usage: %s [-s] [-a pc] [-i instr] [-w addr] [-f step] [-u step] [-m map] <trace>\n",
+                argv[0]);
+        return 1;
+    }
+
+    SourceMap map;
+    if (map_filename && !sourcemap_load(&map, map_filename)) {
+        perror("Error opening source map");
+        return 1;
+    }
+    const SourceMap *source_map = map_filename ? &map : NULL;
+
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        perror("Error opening file");
+        return 1;
+    }
+
+    uint8_t header[5];
+    if (fread(header, 1, 5, file) != 5 || memcmp(header, "NTRC", 4) != 0 ||
+        header[4] != TRACE_VERSION) {
+        fprintf(stderr, "Error: %s: invalid trace header\n", filename);
+        fclose(file);
+        return 1;
+    }
+
+    Summary summary;
+    memset(&summary, 0, sizeof(summary));
+    summary.bytes = sizeof(header);
+
+    uint8_t *data = malloc(TRACE_CHUNK_SIZE);
+    uint8_t chunk_header[12];
+    uint64_t expected_step = 0;
+    int status = 0;
+
+    while (fread(chunk_header, 1, sizeof(chunk_header), file) == sizeof(chunk_header)) {
+        size_t length = (size_t)read_le(chunk_header, 4);
+        uint64_t step = read_le(chunk_header + 4, 8);
+
+        if (length > TRACE_CHUNK_SIZE || fread(data, 1, length, file) != length) {
+            fprintf(stderr, "Error: %s: truncated chunk\n", filename);
+            status = 1;
+            break;
+        }
+
+        if (step > expected_step) {
+            summary.omitted += step - expected_step;
+            if (!summarize) {
+                printf("... %llu steps omitted\n", (unsigned long long)(step - expected_step));
+            }
+        }
+
+        if (!replay_chunk(data, length, &step, &filter, &summary, !summarize, source_map)) {
+            fprintf(stderr, "Error: %s: truncated entry\n", filename);
+            status = 1;
+            break;
+        }
+        summary.bytes += sizeof(chunk_header) + length;
+        expected_step = step;
+    }
+
+    if (summarize) {
+        print_summary(&summary, source_map);
+    }
+
+    free(data);
+    fclose(file);
+    if (source_map) {
+        sourcemap_free(&map);
+    }
+    return status;
+}
@@ -0,0 +1,247 @@
+#include "neander.h"
+
+// Tradutor estático: gera um arquivo C com run_translated() para um .mem.
+// Cada instrução alcançável a partir do endereço 0 vira um rótulo, e um
+// switch no início permite entrar em qualquer pc.
+
+static bool start[MEMORY_SIZE];  // Início de instrução alcançável
+static bool code[MEMORY_SIZE];   // Byte lido como opcode ou operando
+static bool writes_code;         // Algum STA alcançável escreve em código
+
+// Mesmo mapeamento do interpretador: opcodes desconhecidos são NOP
+static uint8_t kind_of(uint8_t opcode) {
+    return (opcode & 0x0F) ? 0 : opcode >> 4;
+}
+
+static uint8_t next_of(const uint8_t *memory, uint8_t pc) {
+    return (uint8_t)(pc + (memory[pc] == NOT ? 1 : 2));
+}
+
+static void discover(const uint8_t *memory, uint8_t pc) {
+    uint8_t stack[MEMORY_SIZE * 2 + 1];
+    int depth = 0;
+
+    stack[depth++] = pc;
+    while (depth > 0) {
+        uint8_t address = stack[--depth];
+        if (start[address]) continue;
+
+        start[address] = true;
+        code[address] = true;
+        if (memory[address] != NOT && memory[address] != HLT) {
+            code[(uint8_t)(address + 1)] = true;
+        }
+
+        uint8_t target = memory[(uint8_t)(address + 1)];
+        switch (kind_of(memory[address])) {
+            case HLT >> 4:
+                break;
+            case JMP >> 4:
+                stack[depth++] = target;
+                break;
+            case JN >> 4:
+            case JZ >> 4:
+                stack[depth++] = target;
+                stack[depth++] = next_of(memory, address);
+                break;
+            default:
+                stack[depth++] = next_of(memory, address);
+                break;
+        }
+    }
+}
+
+// Emite uma instrução; devolve false se ela não segue para a próxima
+static bool emit_instruction(FILE *output, const uint8_t *memory, uint8_t address) {
+    uint8_t operand = memory[(uint8_t)(address + 1)];
+    uint8_t next = next_of(memory, address);
+
+    fprintf(output, "L%02x: // %s", address, opcode_name(memory[address]));
+    if (memory[address] != NOT && memory[address] != HLT) {
+        fprintf(output, " 0x%02x", operand);
+    }
+    fprintf(output, "\n");
+
+    if (memory[address] == HLT) {
+        fprintf(output, "    pc = 0x%02x;\n", address);
+        fprintf(output, "    goto halt;\n");
+        return false;
+    }
+
+    fprintf(output, "    flags_ac = ac;\n");
+    switch (kind_of(memory[address])) {
+        case STA >> 4:
+            fprintf(output, "    m[0x%02x] = ac;\n", operand);
+            if (code[operand]) {
+                writes_code = true;
+                // Escrita em código: se mudou o byte, o interpretador continua
+                fprintf(output, "    if (ac != 0x%02x) {\n", memory[operand]);
+                fprintf(output, "        pc = 0x%02x;\n", next);
+                fprintf(output, "        goto modified;\n");
+                fprintf(output, "    }\n");
+            }
+            break;
+        case LDA >> 4:
+            fprintf(output, "    ac = m[0x%02x];\n", operand);
+            break;
+        case ADD >> 4:
+            fprintf(output, "    ac += m[0x%02x];\n", operand);
+            break;
+        case 0x4:
+            fprintf(output, "    ac |= m[0x%02x];\n", operand);
+            break;
+        case 0x5:
+            fprintf(output, "    ac &= m[0x%02x];\n", operand);
+            break;
+        case NOT >> 4:
+            fprintf(output, "    ac = ~ac;\n");
+            break;
+        case JMP >> 4:
+            fprintf(output, "    goto L%02x;\n", operand);
+            return false;
+        case JN >> 4:
+            fprintf(output, "    if (ac & 0x80) goto L%02x;\n", operand);
+            break;
+        case JZ >> 4:
+            fprintf(output, "    if (ac == 0) goto L%02x;\n", operand);
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+// Separador de tabela: 12 valores por linha
+static const char *separator(int n) {
+    if (n == 0) return "\n    ";
+    return (n % 12) ? ", " : ",\n    ";
+}
+
+static void translate(FILE *output, const uint8_t *memory, const char *filename) {
+    discover(memory, 0);
+
+    fprintf(output, "// Gerado por translate a partir de %s. Não editar.\n", filename);
+    fprintf(output, "#include \"translated.h\"\n\n");
+
+    // Bytes de código que precisam estar iguais à imagem para a tradução valer
+    fprintf(output, "static const uint8_t code_address[] = {");
+    for (int i = 0, n = 0; i < MEMORY_SIZE; i++) {
+        if (!code[i]) continue;
+        fprintf(output, "%s0x%02x", separator(n++), i);
+    }
+    fprintf(output, "\n};\n\n");
+    fprintf(output, "static const uint8_t code_value[] = {");
+    for (int i = 0, n = 0; i < MEMORY_SIZE; i++) {
+        if (!code[i]) continue;
+        fprintf(output, "%s0x%02x", separator(n++), memory[i]);
+    }
+    fprintf(output, "\n};\n\n");
+
+    fprintf(output, "const char translated_source[] = \"");
+    for (const char *c = filename; *c; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', output);
+        fputc(*c, output);
+    }
+    fprintf(output, "\";\n\n");
+
+    fprintf(output,
+            "bool translated_image_matches(const Neander *neander) {\n"
+            "    for (size_t i = 0; i < sizeof(code_address); i++) {\n"
+            "        if (neander->memory[code_address[i]] != code_value[i]) return false;\n"
+            "    }\n"
+            "    return true;\n"
+            "}\n\n");
+
+    fprintf(output,
+            "NeanderStatus run_translated(Neander *neander) {\n"
+            "    uint8_t *m = neander->memory;\n"
+            "    uint8_t ac = neander->ac;\n"
+            "    uint8_t pc = neander->pc;\n"
+            "    uint8_t flags_ac = ac;\n"
+            "    bool executed = m[pc] != HLT;\n"
+            "\n"
+            "    if (!translated_image_matches(neander)) return run(neander);\n"
+            "\n"
+            "    switch (pc) {\n");
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        if (start[i]) fprintf(output, "        case 0x%02x: goto L%02x;\n", i, i);
+    }
+    fprintf(output,
+            "        default: return run(neander);\n"
+            "    }\n"
+            "\n");
+
+    // Instruções em ordem de endereço; o fluxo sequencial só precisa de
+    // goto quando a próxima instrução não é a emitida em seguida
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        if (!start[i]) continue;
+
+        uint8_t address = (uint8_t)i;
+        bool falls_through = emit_instruction(output, memory, address);
+        uint8_t next = next_of(memory, address);
+
+        int following = i + 1;
+        while (following < MEMORY_SIZE && !start[following]) following++;
+        if (falls_through && next != following) {
+            fprintf(output, "    goto L%02x;\n", next);
+        }
+    }
+
+    if (writes_code) {
+        fprintf(output,
+            "\n"
+            "modified:\n"
+            "    // O programa alterou o próprio código: o interpretador termina\n"
+            "    neander->ac = ac;\n"
+            "    neander->pc = pc;\n"
+            "    neander->z = (flags_ac == 0);\n"
+            "    neander->n = (flags_ac & 0x80) != 0;\n"
+            "    return run(neander);\n");
+    }
+
+    fprintf(output,
+            "\n"
+            "halt:\n"
+            "    neander->ac = ac;\n"
+            "    neander->pc = pc;\n"
+            "    if (executed) {\n"
+            "        neander->z = (flags_ac == 0);\n"
+            "        neander->n = (flags_ac & 0x80) != 0;\n"
+            "    }\n"
+            "    return NEANDER_OK;\n"
+            "}\n");
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <input.mem> <output.c>\n", argv[0]);
+        return 1;
+    }
+
+    Neander neander;
+    init_neander(&neander);
+
+    NeanderStatus status = load_neander(&neander, argv[1]);
+    if (status == NEANDER_ERROR_OPEN) {
+        perror("Error opening file");
+        return 1;
+    } else if (status != NEANDER_OK) {
+        fprintf(stderr, "Error: %s: %s\n", argv[1], neander_status_string(status));
+        return 1;
+    }
+
+    FILE *output = fopen(argv[2], "w");
+    if (!output) {
+        perror("Error opening output file");
+        return 1;
+    }
+
+    translate(output, neander.memory, argv[1]);
+
+    if (fclose(output) != 0) {
+        perror("Error writing output file");
+        return 1;
+    }
+
+    return 0;
+}
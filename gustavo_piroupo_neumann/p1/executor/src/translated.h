@@ -0,0 +1,17 @@
+#ifndef TRANSLATED_H
+#define TRANSLATED_H
+
+#include "neander.h"
+
+// Executa como run() o programa traduzido para C por bin/translate.
+// Se a memória não corresponde à imagem traduzida, ou se o programa
+// sobrescreve o próprio código, o restante roda no interpretador.
+NeanderStatus run_translated(Neander *neander);
+
+// Arquivo .mem de que a tradução foi gerada
+extern const char translated_source[];
+
+// Se os bytes de código da memória são os da imagem traduzida
+bool translated_image_matches(const Neander *neander);
+
+#endif // TRANSLATED_H
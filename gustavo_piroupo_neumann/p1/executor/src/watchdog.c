@@ -0,0 +1,130 @@
+#include "watchdog.h"
+
+// Máquina mínima para refazer a execução e achar a entrada do ciclo
+typedef struct {
+    uint8_t memory[MEMORY_SIZE];
+    uint8_t ac;
+    uint8_t pc;
+    uint64_t hash;
+} Replay;
+
+static uint64_t hash_memory(const uint8_t *memory) {
+    uint64_t hash = 0;
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        hash += memory[i] * watchdog_key((uint8_t)i);
+    }
+    return hash;
+}
+
+void init_watchdog(Watchdog *watchdog, bool detect, uint64_t budget) {
+    memset(watchdog, 0, sizeof(Watchdog));
+    watchdog->detect = detect;
+    watchdog->budget = budget;
+}
+
+void watchdog_start(Watchdog *watchdog, const Neander *neander) {
+    watchdog->status = NEANDER_OK;
+    watchdog->hash = hash_memory(neander->memory);
+    memcpy(watchdog->initial_memory, neander->memory, MEMORY_SIZE);
+    watchdog->initial_ac = neander->ac;
+    watchdog->initial_pc = neander->pc;
+    watchdog->saved = false;
+    watchdog->checks = 1;
+    watchdog->power = 1;
+}
+
+// Mesma semântica de run(), uma instrução por vez
+static void replay_step(Replay *replay) {
+    uint8_t opcode = replay->memory[replay->pc];
+    uint8_t address = replay->memory[(uint8_t)(replay->pc + 1)];
+
+    switch ((opcode & 0x0F) ? 0 : opcode >> 4) {
+        case STA >> 4:
+            replay->hash += ((uint64_t)replay->ac - replay->memory[address]) * watchdog_key(address);
+            replay->memory[address] = replay->ac;
+            break;
+        case LDA >> 4: replay->ac = replay->memory[address]; break;
+        case ADD >> 4: replay->ac += replay->memory[address]; break;
+        case 0x4: replay->ac |= replay->memory[address]; break;
+        case 0x5: replay->ac &= replay->memory[address]; break;
+        case NOT >> 4:
+            replay->ac = ~replay->ac;
+            replay->pc += 1;
+            return;
+        case JMP >> 4:
+            replay->pc = address;
+            return;
+        case JN >> 4:
+            replay->pc = (replay->ac & 0x80) ? address : (uint8_t)(replay->pc + 2);
+            return;
+        case JZ >> 4:
+            replay->pc = (replay->ac == 0) ? address : (uint8_t)(replay->pc + 2);
+            return;
+        case HLT >> 4:
+            return;
+    }
+    replay->pc += 2;
+}
+
+static bool same_replay(const Replay *a, const Replay *b) {
+    return a->pc == b->pc && a->ac == b->ac && a->hash == b->hash &&
+           memcmp(a->memory, b->memory, MEMORY_SIZE) == 0;
+}
+
+// Uma máquina length instruções à frente da outra: o primeiro passo em
+// que as duas coincidem é a entrada do ciclo
+static void find_entry(Watchdog *watchdog) {
+    Replay a, b;
+
+    memcpy(a.memory, watchdog->initial_memory, MEMORY_SIZE);
+    a.ac = watchdog->initial_ac;
+    a.pc = watchdog->initial_pc;
+    a.hash = hash_memory(a.memory);
+    b = a;
+
+    for (uint64_t i = 0; i < watchdog->length; i++) {
+        replay_step(&b);
+    }
+
+    uint64_t step = 0;
+    while (!same_replay(&a, &b)) {
+        replay_step(&a);
+        replay_step(&b);
+        step++;
+    }
+
+    watchdog->entry_step = step;
+    watchdog->entry = a.pc;
+}
+
+bool watchdog_check(Watchdog *watchdog, const uint8_t *memory, uint8_t pc, uint8_t ac,
+                    uint64_t steps) {
+    if (watchdog->budget && steps >= watchdog->budget) {
+        watchdog->status = NEANDER_BUDGET;
+        return false;
+    }
+    if (!watchdog->detect) {
+        return true;
+    }
+
+    if (watchdog->saved && watchdog->hash == watchdog->saved_hash && pc == watchdog->saved_pc &&
+        ac == watchdog->saved_ac && memcmp(memory, watchdog->saved_memory, MEMORY_SIZE) == 0) {
+        watchdog->length = steps - watchdog->saved_steps;
+        find_entry(watchdog);
+        watchdog->status = NEANDER_LOOP;
+        return false;
+    }
+
+    if (watchdog->checks == watchdog->power) {
+        watchdog->saved = true;
+        watchdog->saved_hash = watchdog->hash;
+        watchdog->saved_steps = steps;
+        watchdog->saved_pc = pc;
+        watchdog->saved_ac = ac;
+        memcpy(watchdog->saved_memory, memory, MEMORY_SIZE);
+        watchdog->power *= 2;
+        watchdog->checks = 0;
+    }
+    watchdog->checks++;
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <stdint.h>
+
+#include "neander.h"
+
+/*
+ * Detecção de laço infinito para run(). O estado que decide o futuro da
+ * máquina é (pc, AC, memória): os flags são derivados do AC e JN/JZ
+ * olham o próprio AC. Como o estado é finito, uma repetição exata prova
+ * que o programa não termina.
+ *
+ * A memória tem um hash incremental, a soma de memory[a] * chave(a),
+ * atualizado a cada STA. A cada volta para trás do pc (desvio para trás
+ * ou pc que passou de 255 para 0) o estado é comparado com um estado
+ * guardado, que é trocado em intervalos que dobram (algoritmo de Brent).
+ * A primeira repetição dá o comprimento exato do ciclo; a entrada é
+ * encontrada refazendo a execução desde o carregamento.
+ */
+
+struct Watchdog {
+    bool detect;            // Procura repetições de estado
+    uint64_t budget;        // Máximo de instruções, 0: sem limite
+    NeanderStatus status;   // Motivo da parada
+
+    uint64_t hash;          // Hash incremental da memória
+    uint8_t initial_memory[MEMORY_SIZE];
+    uint8_t initial_ac;
+    uint8_t initial_pc;
+
+    bool saved;             // Estado guardado para comparação
+    uint64_t saved_hash;
+    uint64_t saved_steps;
+    uint8_t saved_memory[MEMORY_SIZE];
+    uint8_t saved_pc;
+    uint8_t saved_ac;
+    uint64_t checks;        // Verificações desde o último estado guardado
+    uint64_t power;
+
+    uint64_t length;        // Instruções por volta do ciclo
+    uint64_t entry_step;    // Primeira instrução dentro do ciclo
+    uint8_t entry;          // pc da entrada do ciclo
+};
+
+void init_watchdog(Watchdog *watchdog, bool detect, uint64_t budget);
+
+// Chamado por run() antes de executar
+void watchdog_start(Watchdog *watchdog, const Neander *neander);
+
+// Chamado por run() quando o pc volta; devolve false se a execução deve parar
+bool watchdog_check(Watchdog *watchdog, const uint8_t *memory, uint8_t pc, uint8_t ac,
+                    uint64_t steps);
+
+static inline uint64_t watchdog_key(uint8_t address) {
+    uint64_t key = (address + 1) * 0x9E3779B97F4A7C15ull;
+    key ^= key >> 29;
+    return key | 1;
+}
+
+// Chamado por run() antes de um STA sobrescrever memory[address]
+static inline void watchdog_store(Watchdog *watchdog, uint8_t address, uint8_t old,
+                                  uint8_t value) {
+    watchdog->hash += ((uint64_t)value - old) * watchdog_key(address);
+}
+
+#endif // WATCHDOG_H
@@ -0,0 +1,267 @@
+#include <stdlib.h>
+#include <string.h>
+#include "bfcode.h"
+
+#define INITIAL_OPS 256
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+static const unsigned char compact_magic[4] = {0x89, 'B', 'F', 'R'};
+
+void bf_program_init(BfProgram* program) {
+    memset(program, 0, sizeof(BfProgram));
+    program->source_hash = FNV_OFFSET;
+}
+
+void bf_program_free(BfProgram* program) {
+    free(program->ops);
+    bf_program_init(program);
+}
+
+int bf_is_command(int c) {
+    return c == '>' || c == '<' || c == '+' || c == '-' ||
+           c == '.' || c == ',' || c == '[' || c == ']';
+}
+
+static int is_run(char op) {
+    return op == '+' || op == '-' || op == '>' || op == '<';
+}
+
+static int push_op(BfProgram* program, char op, uint32_t arg) {
+    if (program->count == program->capacity) {
+        uint32_t capacity = program->capacity ? program->capacity * 2 : INITIAL_OPS;
+        BfOp* ops = realloc(program->ops, capacity * sizeof(BfOp));
+        if (!ops) {
+            fprintf(stderr, "Erro: Memória insuficiente para o programa\n");
+            return 0;
+        }
+        program->ops = ops;
+        program->capacity = capacity;
+    }
+
+    program->ops[program->count].op = op;
+    program->ops[program->count].arg = arg;
+    program->count++;
+    return 1;
+}
+
+// Acrescenta count repetições do comando, juntando com a sequência anterior
+int bf_program_append(BfProgram* program, char op, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        program->source_hash = (program->source_hash ^ (unsigned char)op) * FNV_PRIME;
+    }
+    program->source_length += count;
+
+    if (is_run(op)) {
+        if (program->count > 0 && program->ops[program->count - 1].op == op) {
+            program->ops[program->count - 1].arg += count;
+            return 1;
+        }
+        return push_op(program, op, count);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (!push_op(program, op, 1)) return 0;
+    }
+    return 1;
+}
+
+// Resolve os pares de colchetes; arg passa a ser o índice do par
+int bf_program_link(BfProgram* program) {
+    uint32_t* stack = malloc((program->count + 1) * sizeof(uint32_t));
+    uint32_t depth = 0;
+    uint32_t position = 0;
+
+    if (!stack) {
+        fprintf(stderr, "Erro: Memória insuficiente para o programa\n");
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < program->count; i++) {
+        BfOp* op = &program->ops[i];
+
+        if (op->op == '[') {
+            stack[depth++] = i;
+        } else if (op->op == ']') {
+            if (depth == 0) {
+                fprintf(stderr, "Erro: ']' na posição %u sem '[' correspondente\n", position);
+                free(stack);
+                return 0;
+            }
+            uint32_t open = stack[--depth];
+            program->ops[open].arg = i;
+            op->arg = open;
+        }
+
+        position += (op->op == '[' || op->op == ']') ? 1 : op->arg;
+    }
+
+    if (depth > 0) {
+        uint32_t open = stack[depth - 1];
+        uint32_t open_position = 0;
+        for (uint32_t i = 0; i < open; i++) {
+            BfOp* op = &program->ops[i];
+            open_position += (op->op == '[' || op->op == ']') ? 1 : op->arg;
+        }
+        fprintf(stderr, "Erro: '[' na posição %u sem ']' correspondente\n", open_position);
+        free(stack);
+        return 0;
+    }
+
+    free(stack);
+    return 1;
+}
+
+// Lê texto BF ignorando comentários
+int bf_program_read_text(BfProgram* program, FILE* input) {
+    int c;
+
+    while ((c = getc(input)) != EOF) {
+        if (bf_is_command(c) && !bf_program_append(program, (char)c, 1)) {
+            return 0;
+        }
+    }
+
+    return bf_program_link(program);
+}
+
+static int read_varint(FILE* input, uint32_t* value) {
+    uint32_t result = 0;
+
+    for (int shift = 0; shift < 35; shift += 7) {
+        int byte = getc(input);
+        if (byte == EOF) return 0;
+        result |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void write_varint(FILE* output, uint32_t value) {
+    while (value >= 0x80) {
+        putc((int)((value & 0x7f) | 0x80), output);
+        value >>= 7;
+    }
+    putc((int)value, output);
+}
+
+int bf_program_read_compact(BfProgram* program, FILE* input) {
+    unsigned char header[5];
+    uint32_t count, source_length, source_hash = 0;
+    unsigned char hash_bytes[4];
+
+    if (fread(header, 1, 5, input) != 5 || memcmp(header, compact_magic, 4) != 0) {
+        fprintf(stderr, "Erro: Cabeçalho BF compacto inválido\n");
+        return 0;
+    }
+    if (header[4] != BF_COMPACT_VERSION) {
+        fprintf(stderr, "Erro: Versão %u do formato compacto não suportada\n", header[4]);
+        return 0;
+    }
+    if (!read_varint(input, &count) || !read_varint(input, &source_length) ||
+        fread(hash_bytes, 1, 4, input) != 4) {
+        fprintf(stderr, "Erro: Cabeçalho BF compacto truncado\n");
+        return 0;
+    }
+    for (int i = 3; i >= 0; i--) {
+        source_hash = (source_hash << 8) | hash_bytes[i];
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        int op = getc(input);
+        uint32_t arg;
+
+        if (!bf_is_command(op) || !read_varint(input, &arg)) {
+            fprintf(stderr, "Erro: Operação %u inválida no BF compacto\n", i);
+            return 0;
+        }
+
+        if (op == '[') {
+            arg = i + arg;
+        } else if (op == ']') {
+            if (arg > i) arg = count;
+            else arg = i - arg;
+        } else {
+            // Reconstrói o hash do texto equivalente
+            for (uint32_t j = 0; j < arg; j++) {
+                program->source_hash = (program->source_hash ^ (unsigned char)op) * FNV_PRIME;
+            }
+            program->source_length += arg;
+        }
+
+        if (op == '[' || op == ']') {
+            program->source_hash = (program->source_hash ^ (unsigned char)op) * FNV_PRIME;
+            program->source_length++;
+        }
+
+        if (!push_op(program, (char)op, arg)) return 0;
+    }
+
+    // Os colchetes vêm pré-resolvidos; só confere que os pares são consistentes
+    for (uint32_t i = 0; i < count; i++) {
+        BfOp* op = &program->ops[i];
+        if (op->op != '[' && op->op != ']') continue;
+
+        char pair = (op->op == '[') ? ']' : '[';
+        if (op->arg >= count || program->ops[op->arg].op != pair ||
+            program->ops[op->arg].arg != i) {
+            fprintf(stderr, "Erro: Colchete %u sem par no BF compacto\n", i);
+            return 0;
+        }
+    }
+
+    if (program->source_length != source_length || program->source_hash != source_hash) {
+        fprintf(stderr, "Erro: Hash do BF compacto não confere\n");
+        return 0;
+    }
+
+    return 1;
+}
+
+// Detecta o formato pelo primeiro byte
+int bf_program_read(BfProgram* program, FILE* input) {
+    int c = getc(input);
+    if (c == EOF) return 1;
+    ungetc(c, input);
+
+    if (c == compact_magic[0]) {
+        return bf_program_read_compact(program, input);
+    }
+    return bf_program_read_text(program, input);
+}
+
+void bf_program_write_text(const BfProgram* program, FILE* output) {
+    for (uint32_t i = 0; i < program->count; i++) {
+        const BfOp* op = &program->ops[i];
+        uint32_t repeat = (op->op == '[' || op->op == ']') ? 1 : op->arg;
+
+        for (uint32_t j = 0; j < repeat; j++) {
+            putc(op->op, output);
+        }
+    }
+}
+
+void bf_program_write_compact(const BfProgram* program, FILE* output) {
+    fwrite(compact_magic, 1, 4, output);
+    putc(BF_COMPACT_VERSION, output);
+    write_varint(output, program->count);
+    write_varint(output, program->source_length);
+    for (int i = 0; i < 4; i++) {
+        putc((int)((program->source_hash >> (8 * i)) & 0xff), output);
+    }
+
+    for (uint32_t i = 0; i < program->count; i++) {
+        const BfOp* op = &program->ops[i];
+        uint32_t arg = op->arg;
+
+        if (op->op == '[') arg = op->arg - i;
+        else if (op->op == ']') arg = i - op->arg;
+
+        putc(op->op, output);
+        write_varint(output, arg);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef BFCODE_H
+#define BFCODE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Programa Brainfuck como sequência de operações já dobradas.
+ *
+ * Formato compacto (versão 1), todos os inteiros em little-endian:
+ *
+ *   0x89 'B' 'F' 'R'      magic
+ *   u8      versão        (BF_COMPACT_VERSION)
+ *   varint  número de operações
+ *   varint  tamanho do texto BF equivalente
+ *   u32     hash FNV-1a do texto BF equivalente
+ *   repetido para cada operação:
+ *     u8     comando ('+', '-', '>', '<', '.', ',', '[', ']')
+ *     varint contagem da sequência, ou distância até o colchete par
+ *
+ * varint é LEB128 sem sinal. Expandir as operações reproduz exatamente os
+ * comandos do texto original (comentários não são preservados).
+ */
+
+#define BF_COMPACT_VERSION 1
+
+typedef struct {
+    char op;
+    uint32_t arg; // contagem, ou índice do colchete correspondente
+} BfOp;
+
+typedef struct {
+    BfOp* ops;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t source_length;
+    uint32_t source_hash;
+} BfProgram;
+
+void bf_program_init(BfProgram* program);
+void bf_program_free(BfProgram* program);
+
+int bf_is_command(int c);
+int bf_program_append(BfProgram* program, char op, uint32_t count);
+int bf_program_link(BfProgram* program);
+
+int bf_program_read_text(BfProgram* program, FILE* input);
+int bf_program_read_compact(BfProgram* program, FILE* input);
+int bf_program_read(BfProgram* program, FILE* input);
+
+void bf_program_write_text(const BfProgram* program, FILE* output);
+void bf_program_write_compact(const BfProgram* program, FILE* output);
+
+#endif // BFCODE_H
@@ -2,71 +2,55 @@
 #include <stdlib.h>
 #include <string.h>
 #include <locale.h>
-#include <ctype.h>
+
+#include "bfcode.h"
+#include "expr.h"
 
 #define MEMORY_SIZE 30000
-#define PROGRAM_SIZE 1000000
 #define OUTPUT_SIZE 10000
 
-typedef struct Node Node;
-struct Node {
-    enum { NUM_NODE, OP_NODE, VAR_NODE } type;
-    union {
-        int number;
-        struct {
-            char operator;
-            Node *left_child, *right_child;
-        };
-        char variable[256];
-    };
-};
-
-typedef struct {
-    const char* source;
-    int index;
-    char current_char;
-    int current_num;
-    char current_identifier[256];
-} ExprParser;
-
-void expr_advance_parser(ExprParser* parser);
-Node* expr_parse_assignment(ExprParser* parser);
-Node* expr_parse_expression(ExprParser* parser);
-Node* expr_parse_term(ExprParser* parser);
-Node* expr_parse_factor(ExprParser* parser);
-int eval_expression(Node* node);
+int eval_expression(const ExprArena* arena, NodeId id);
 
-int main() {
+int main(int argc, char* argv[]) {
     setlocale(LC_ALL, "C.UTF-8");
     
-    char program[PROGRAM_SIZE];
+    BfProgram program;
     unsigned char memory[MEMORY_SIZE];
     unsigned char* ptr;
     char output_buffer[OUTPUT_SIZE] = {0};
     int output_pos = 0;
-    int program_size = 0;
-    int pc = 0;
-    int c;
+    uint32_t pc = 0;
     
     // Inicializa memória
     memset(memory, 0, MEMORY_SIZE);
     ptr = memory;
     
-    // Lê o programa Brainfuck
-    while ((c = getchar()) != EOF && program_size < PROGRAM_SIZE - 1) {
-        if (c == '>' || c == '<' || c == '+' || c == '-' || 
-            c == '.' || c == ',' || c == '[' || c == ']') {
-            program[program_size++] = c;
+    // Lê o programa Brainfuck (texto ou compacto)
+    bf_program_init(&program);
+    if (!bf_program_read(&program, stdin)) {
+        bf_program_free(&program);
+        return 1;
+    }
+    
+    // -t e -c só convertem o programa, sem executar
+    if (argc > 1 && (strcmp(argv[1], "-t") == 0 || strcmp(argv[1], "-c") == 0)) {
+        if (argv[1][1] == 't') {
+            bf_program_write_text(&program, stdout);
+        } else {
+            bf_program_write_compact(&program, stdout);
         }
+        bf_program_free(&program);
+        return 0;
     }
-    program[program_size] = '\0';
     
     // Executa o programa e captura a saída
-    while (pc < program_size) {
-        switch (program[pc]) {
+    while (pc < program.count) {
+        BfOp* op = &program.ops[pc];
+        
+        switch (op->op) {
             case '>':
-                if (ptr < memory + MEMORY_SIZE - 1) {
-                    ptr++;
+                if (op->arg <= (uint32_t)(memory + MEMORY_SIZE - 1 - ptr)) {
+                    ptr += op->arg;
                 } else {
                     fprintf(stderr, "Erro: Movimento além do limite superior da memória\n");
                     return 1;
@@ -74,8 +58,8 @@ int main() {
                 break;
                 
             case '<':
-                if (ptr > memory) {
-                    ptr--;
+                if (op->arg <= (uint32_t)(ptr - memory)) {
+                    ptr -= op->arg;
                 } else {
                     fprintf(stderr, "Erro: Movimento além do limite inferior da memória\n");
                     return 1;
@@ -83,22 +67,22 @@ int main() {
                 break;
                 
             case '+':
-                (*ptr)++;
+                *ptr += (unsigned char)op->arg;
                 break;
                 
             case '-':
-                (*ptr)--;
+                *ptr -= (unsigned char)op->arg;
                 break;
                 
             case '.':
-                if (output_pos < OUTPUT_SIZE - 1) {
+                for (uint32_t i = 0; i < op->arg && output_pos < OUTPUT_SIZE - 1; i++) {
                     output_buffer[output_pos++] = *ptr;
                     output_buffer[output_pos] = '\0';
                 }
                 break;
                 
             case ',':
-                {
+                for (uint32_t i = 0; i < op->arg; i++) {
                     int input = getchar();
                     if (input != EOF) {
                         *ptr = (unsigned char)input;
@@ -110,43 +94,13 @@ int main() {
                 
             case '[':
                 if (*ptr == 0) {
-                    int bracket_count = 1;
-                    int original_pc = pc;
-                    
-                    while (bracket_count > 0 && pc < program_size - 1) {
-                        pc++;
-                        if (program[pc] == '[') {
-                            bracket_count++;
-                        } else if (program[pc] == ']') {
-                            bracket_count--;
-                        }
-                    }
-                    
-                    if (bracket_count > 0) {
-                        fprintf(stderr, "Erro: '[' na posição %d sem ']' correspondente\n", original_pc);
-                        return 1;
-                    }
+                    pc = op->arg;
                 }
                 break;
                 
             case ']':
                 if (*ptr != 0) {
-                    int bracket_count = 1;
-                    int original_pc = pc;
-                    
-                    while (bracket_count > 0 && pc > 0) {
-                        pc--;
-                        if (program[pc] == ']') {
-                            bracket_count++;
-                        } else if (program[pc] == '[') {
-                            bracket_count--;
-                        }
-                    }
-                    
-                    if (bracket_count > 0) {
-                        fprintf(stderr, "Erro: ']' na posição %d sem '[' correspondente\n", original_pc);
-                        return 1;
-                    }
+                    pc = op->arg;
                 }
                 break;
         }
@@ -154,6 +108,8 @@ int main() {
         pc++;
     }
     
+    bf_program_free(&program);
+    
     char* equals_pos = strchr(output_buffer, '=');
     if (equals_pos && equals_pos > output_buffer) {
         *equals_pos = '\0';
@@ -168,16 +124,22 @@ int main() {
             end--;
         }
 
-        ExprParser parser = {expression, 0};
+        ExprArena arena;
+        expr_arena_init(&arena);
+        
+        ExprParser parser;
+        expr_parser_init(&parser, &arena, expression);
         expr_advance_parser(&parser);
         
-        Node* expr_ast = expr_parse_expression(&parser);
+        NodeId expr_ast = expr_parse_expression(&parser);
         if (expr_ast) {
-            int result = eval_expression(expr_ast);
+            int result = eval_expression(&arena, expr_ast);
             printf("%s = %d\n", var_name, result);
         } else {
             printf("Erro: Não foi possível parsear a expressão\n");
         }
+        
+        expr_arena_free(&arena);
     } else {
         printf("Saída: %s\n", output_buffer);
     }
@@ -185,114 +147,10 @@ int main() {
     return 0;
 }
 
-void expr_advance_parser(ExprParser* parser) {
-    while (parser->source[parser->index] == ' ' || 
-           parser->source[parser->index] == '\t') {
-        parser->index++;
-    }
-    
-    if (parser->source[parser->index] == '\0') {
-        parser->current_char = '\0';
-        return;
-    }
-    
-    unsigned char ch = (unsigned char)parser->source[parser->index];
-    
-    if (isalpha(ch) || ch >= 0x80) {
-        int i = 0;
-        while ((isalnum((unsigned char)parser->source[parser->index]) || 
-                parser->source[parser->index] == '_' || 
-                (unsigned char)parser->source[parser->index] >= 0x80) && 
-               i < 255) {
-            parser->current_identifier[i++] = parser->source[parser->index++];
-        }
-        parser->current_identifier[i] = '\0';
-        parser->current_char = 'I';
-    } else if (isdigit(ch)) {
-        parser->current_num = 0;
-        while (isdigit(parser->source[parser->index])) {
-            parser->current_num = parser->current_num * 10 + 
-                                 (parser->source[parser->index] - '0');
-            parser->index++;
-        }
-        parser->current_char = 'N';
-    } else {
-        parser->current_char = parser->source[parser->index++];
-    }
-}
-
-Node* expr_parse_expression(ExprParser* parser) {
-    Node* left = expr_parse_term(parser);
-    if (!left) return NULL;
-    
-    while (parser->current_char == '+' || parser->current_char == '-') {
-        char op = parser->current_char;
-        expr_advance_parser(parser);
-        
-        Node* right = expr_parse_term(parser);
-        if (!right) return NULL;
-        
-        Node* op_node = malloc(sizeof(Node));
-        op_node->type = OP_NODE;
-        op_node->operator = op;
-        op_node->left_child = left;
-        op_node->right_child = right;
-        left = op_node;
-    }
-    
-    return left;
-}
-
-Node* expr_parse_term(ExprParser* parser) {
-    Node* left = expr_parse_factor(parser);
-    if (!left) return NULL;
-    
-    while (parser->current_char == '*' || parser->current_char == '/') {
-        char op = parser->current_char;
-        expr_advance_parser(parser);
-        
-        Node* right = expr_parse_factor(parser);
-        if (!right) return NULL;
-        
-        Node* op_node = malloc(sizeof(Node));
-        op_node->type = OP_NODE;
-        op_node->operator = op;
-        op_node->left_child = left;
-        op_node->right_child = right;
-        left = op_node;
-    }
-    
-    return left;
-}
-
-Node* expr_parse_factor(ExprParser* parser) {
-    if (parser->current_char == 'N') {
-        Node* num_node = malloc(sizeof(Node));
-        num_node->type = NUM_NODE;
-        num_node->number = parser->current_num;
-        expr_advance_parser(parser);
-        return num_node;
-    } else if (parser->current_char == '(') {
-        expr_advance_parser(parser);
-        Node* expr = expr_parse_expression(parser);
-        if (parser->current_char == ')') {
-            expr_advance_parser(parser);
-        }
-        return expr;
-    } else if (parser->current_char == 'I') {
-        Node* var_node = malloc(sizeof(Node));
-        var_node->type = VAR_NODE;
-        strcpy(var_node->variable, parser->current_identifier);
-        expr_advance_parser(parser);
-        return var_node;
-    }
-    
-    return NULL;
-}
-
-int eval_expression(Node* node) {
-    if (!node) return 0;
+int eval_expression(const ExprArena* arena, NodeId id) {
+    if (!id) return 0;
     
+    const Node* node = expr_node(arena, id);
     switch (node->type) {
         case NUM_NODE:
             return node->number;
@@ -302,8 +160,8 @@ int eval_expression(Node* node) {
             
         case OP_NODE:
             {
-                int left = eval_expression(node->left_child);
-                int right = eval_expression(node->right_child);
+                int left = eval_expression(arena, node->left_child);
+                int right = eval_expression(arena, node->right_child);
                 
                 switch (node->operator) {
                     case '+': return left + right;
@@ -0,0 +1,362 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "expr.h"
+
+_Static_assert(sizeof(Node) <= 16, "Node deve caber em 16 bytes");
+
+#define INITIAL_NODES 64
+#define INITIAL_SLOTS 128
+#define INITIAL_NAMES 256
+
+void expr_arena_init(ExprArena* arena) {
+    memset(arena, 0, sizeof(ExprArena));
+    arena->node_count = 1; // índice 0 é o nó nulo
+}
+
+// Esvazia a arena mantendo os buffers para a próxima análise
+void expr_arena_reset(ExprArena* arena) {
+    arena->node_count = 1;
+    arena->names_size = 0;
+    arena->name_count = 0;
+    if (arena->node_slots) {
+        memset(arena->node_slots, 0, arena->node_slot_count * sizeof(NodeId));
+    }
+    if (arena->name_slots) {
+        memset(arena->name_slots, 0, arena->name_slot_count * sizeof(uint32_t));
+    }
+}
+
+void expr_arena_free(ExprArena* arena) {
+    free(arena->nodes);
+    free(arena->node_slots);
+    free(arena->names);
+    free(arena->name_slots);
+    expr_arena_init(arena);
+}
+
+static uint32_t hash_bytes(const char* bytes, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t hash_node(const Node* node) {
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ node->type) * 16777619u;
+    hash = (hash ^ (unsigned char)node->operator) * 16777619u;
+    hash = (hash ^ node->left_child) * 16777619u;
+    hash = (hash ^ node->right_child) * 16777619u;
+    return hash;
+}
+
+static int same_node(const Node* a, const Node* b) {
+    return a->type == b->type && a->operator == b->operator &&
+           a->left_child == b->left_child && a->right_child == b->right_child;
+}
+
+// Dobra a tabela de nomes e reinsere os nomes existentes
+static int grow_name_slots(ExprArena* arena) {
+    uint32_t count = arena->name_slot_count ? arena->name_slot_count * 2 : INITIAL_SLOTS;
+    uint32_t* slots = calloc(count, sizeof(uint32_t));
+    if (!slots) return 0;
+
+    for (uint32_t i = 0; i < arena->name_slot_count; i++) {
+        uint32_t entry = arena->name_slots[i];
+        if (!entry) continue;
+        const char* name = arena->names + entry - 1;
+        uint32_t index = hash_bytes(name, strlen(name)) & (count - 1);
+        while (slots[index]) index = (index + 1) & (count - 1);
+        slots[index] = entry;
+    }
+
+    free(arena->name_slots);
+    arena->name_slots = slots;
+    arena->name_slot_count = count;
+    return 1;
+}
+
+static int grow_node_slots(ExprArena* arena) {
+    uint32_t count = arena->node_slot_count ? arena->node_slot_count * 2 : INITIAL_SLOTS;
+    NodeId* slots = calloc(count, sizeof(NodeId));
+    if (!slots) return 0;
+
+    for (uint32_t i = 0; i < arena->node_slot_count; i++) {
+        NodeId id = arena->node_slots[i];
+        if (!id) continue;
+        uint32_t index = hash_node(&arena->nodes[id]) & (count - 1);
+        while (slots[index]) index = (index + 1) & (count - 1);
+        slots[index] = id;
+    }
+
+    free(arena->node_slots);
+    arena->node_slots = slots;
+    arena->node_slot_count = count;
+    return 1;
+}
+
+// Devolve o id do nome, copiando-o para a tabela só na primeira vez
+uint32_t expr_intern_name(ExprArena* arena, const char* name, size_t length) {
+    if ((arena->name_count + 1) * 2 > arena->name_slot_count && !grow_name_slots(arena)) {
+        fprintf(stderr, "Erro: Memória insuficiente para identificadores\n");
+        exit(1);
+    }
+
+    uint32_t mask = arena->name_slot_count - 1;
+    uint32_t index = hash_bytes(name, length) & mask;
+
+    while (arena->name_slots[index]) {
+        const char* existing = arena->names + arena->name_slots[index] - 1;
+        if (strncmp(existing, name, length) == 0 && existing[length] == '\0') {
+            return arena->name_slots[index] - 1;
+        }
+        index = (index + 1) & mask;
+    }
+
+    if (arena->names_size + length + 1 > arena->names_capacity) {
+        uint32_t capacity = arena->names_capacity ? arena->names_capacity : INITIAL_NAMES;
+        while (arena->names_size + length + 1 > capacity) capacity *= 2;
+        char* names = realloc(arena->names, capacity);
+        if (!names) {
+            fprintf(stderr, "Erro: Memória insuficiente para identificadores\n");
+            exit(1);
+        }
+        arena->names = names;
+        arena->names_capacity = capacity;
+    }
+
+    uint32_t offset = arena->names_size;
+    memcpy(arena->names + offset, name, length);
+    arena->names[offset + length] = '\0';
+    arena->names_size += length + 1;
+
+    arena->name_slots[index] = offset + 1;
+    arena->name_count++;
+    return offset;
+}
+
+const char* expr_name(const ExprArena* arena, uint32_t name) {
+    return arena->names + name;
+}
+
+// Hash-consing: nós estruturalmente iguais viram um só (DAG)
+static NodeId intern_node(ExprArena* arena, const Node* node) {
+    if (arena->node_count * 2 > arena->node_slot_count && !grow_node_slots(arena)) {
+        fprintf(stderr, "Erro: Memória insuficiente para a árvore\n");
+        exit(1);
+    }
+
+    uint32_t mask = arena->node_slot_count - 1;
+    uint32_t index = hash_node(node) & mask;
+
+    while (arena->node_slots[index]) {
+        NodeId existing = arena->node_slots[index];
+        if (same_node(&arena->nodes[existing], node)) {
+            return existing;
+        }
+        index = (index + 1) & mask;
+    }
+
+    if (arena->node_count >= arena->node_capacity) {
+        uint32_t capacity = arena->node_capacity ? arena->node_capacity * 2 : INITIAL_NODES;
+        Node* nodes = realloc(arena->nodes, capacity * sizeof(Node));
+        if (!nodes) {
+            fprintf(stderr, "Erro: Memória insuficiente para a árvore\n");
+            exit(1);
+        }
+        arena->nodes = nodes;
+        arena->node_capacity = capacity;
+    }
+
+    NodeId id = arena->node_count++;
+    arena->nodes[id] = *node;
+    arena->node_slots[index] = id;
+    return id;
+}
+
+NodeId expr_make_number(ExprArena* arena, int number) {
+    Node node = {0};
+    node.type = NUM_NODE;
+    node.number = number;
+    return intern_node(arena, &node);
+}
+
+NodeId expr_make_variable(ExprArena* arena, uint32_t name) {
+    Node node = {0};
+    node.type = VAR_NODE;
+    node.name = name;
+    return intern_node(arena, &node);
+}
+
+static int is_number(const ExprArena* arena, NodeId id, int value) {
+    const Node* node = expr_node(arena, id);
+    return node->type == NUM_NODE && node->number == value;
+}
+
+// Dobra constantes e aplica identidades algébricas antes de criar o nó.
+// A divisão por zero não é dobrada.
+NodeId expr_make_op(ExprArena* arena, char operator, NodeId left, NodeId right) {
+    const Node* l = expr_node(arena, left);
+    const Node* r = expr_node(arena, right);
+
+    if (l->type == NUM_NODE && r->type == NUM_NODE) {
+        int a = l->number;
+        int b = r->number;
+
+        switch (operator) {
+            case '+': return expr_make_number(arena, a + b);
+            case '-': return expr_make_number(arena, a - b);
+            case '*': return expr_make_number(arena, a * b);
+            case '/':
+                if (b != 0) return expr_make_number(arena, a / b);
+                break;
+        }
+    }
+
+    switch (operator) {
+        case '+':
+            if (is_number(arena, right, 0)) return left;
+            if (is_number(arena, left, 0)) return right;
+            break;
+        case '-':
+            if (is_number(arena, right, 0)) return left;
+            break;
+        case '*':
+            if (is_number(arena, right, 1)) return left;
+            if (is_number(arena, left, 1)) return right;
+            if (is_number(arena, left, 0) || is_number(arena, right, 0)) {
+                return expr_make_number(arena, 0);
+            }
+            break;
+        case '/':
+            if (is_number(arena, right, 1)) return left;
+            break;
+    }
+
+    Node node = {0};
+    node.type = OP_NODE;
+    node.operator = operator;
+    node.left_child = left;
+    node.right_child = right;
+    return intern_node(arena, &node);
+}
+
+void expr_parser_init(ExprParser* parser, ExprArena* arena, const char* source) {
+    parser->source = source;
+    parser->index = 0;
+    parser->current_char = '\0';
+    parser->current_num = 0;
+    parser->current_identifier = 0;
+    parser->arena = arena;
+}
+
+void expr_advance_parser(ExprParser* parser) {
+    while (parser->source[parser->index] == ' ' ||
+           parser->source[parser->index] == '\t') {
+        parser->index++;
+    }
+
+    if (parser->source[parser->index] == '\0') {
+        parser->current_char = '\0';
+        return;
+    }
+
+    unsigned char ch = (unsigned char)parser->source[parser->index];
+
+    if (isalpha(ch) || ch >= 0x80) {
+        int start = parser->index;
+        while (isalnum((unsigned char)parser->source[parser->index]) ||
+               parser->source[parser->index] == '_' ||
+               (unsigned char)parser->source[parser->index] >= 0x80) {
+            parser->index++;
+        }
+        parser->current_identifier = expr_intern_name(parser->arena, parser->source + start,
+                                                      parser->index - start);
+        parser->current_char = 'I';
+    } else if (isdigit(ch)) {
+        parser->current_num = 0;
+        while (isdigit(parser->source[parser->index])) {
+            parser->current_num = parser->current_num * 10 +
+                                 (parser->source[parser->index] - '0');
+            parser->index++;
+        }
+        parser->current_char = 'N';
+    } else {
+        parser->current_char = parser->source[parser->index++];
+    }
+}
+
+NodeId expr_parse_assignment(ExprParser* parser) {
+    if (parser->current_char != 'I') return NULL_NODE;
+
+    NodeId var_node = expr_make_variable(parser->arena, parser->current_identifier);
+
+    expr_advance_parser(parser);
+
+    if (parser->current_char != '=') return NULL_NODE;
+
+    expr_advance_parser(parser);
+
+    NodeId expr_node = expr_parse_expression(parser);
+    if (!expr_node) return NULL_NODE;
+
+    return expr_make_op(parser->arena, '=', var_node, expr_node);
+}
+
+NodeId expr_parse_expression(ExprParser* parser) {
+    NodeId left = expr_parse_term(parser);
+    if (!left) return NULL_NODE;
+
+    while (parser->current_char == '+' || parser->current_char == '-') {
+        char op = parser->current_char;
+        expr_advance_parser(parser);
+
+        NodeId right = expr_parse_term(parser);
+        if (!right) return NULL_NODE;
+
+        left = expr_make_op(parser->arena, op, left, right);
+    }
+
+    return left;
+}
+
+NodeId expr_parse_term(ExprParser* parser) {
+    NodeId left = expr_parse_factor(parser);
+    if (!left) return NULL_NODE;
+
+    while (parser->current_char == '*' || parser->current_char == '/') {
+        char op = parser->current_char;
+        expr_advance_parser(parser);
+
+        NodeId right = expr_parse_factor(parser);
+        if (!right) return NULL_NODE;
+
+        left = expr_make_op(parser->arena, op, left, right);
+    }
+
+    return left;
+}
+
+NodeId expr_parse_factor(ExprParser* parser) {
+    if (parser->current_char == 'N') {
+        NodeId num_node = expr_make_number(parser->arena, parser->current_num);
+        expr_advance_parser(parser);
+        return num_node;
+    } else if (parser->current_char == '(') {
+        expr_advance_parser(parser);
+        NodeId expr = expr_parse_expression(parser);
+        if (parser->current_char == ')') {
+            expr_advance_parser(parser);
+        }
+        return expr;
+    } else if (parser->current_char == 'I') {
+        NodeId var_node = expr_make_variable(parser->arena, parser->current_identifier);
+        expr_advance_parser(parser);
+        return var_node;
+    }
+
+    return NULL_NODE;
+}
@@ -0,0 +1,76 @@
+#ifndef EXPR_H
+#define EXPR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Nós são índices na arena; 0 é o nó nulo
+typedef uint32_t NodeId;
+#define NULL_NODE 0
+
+enum { NUM_NODE, OP_NODE, VAR_NODE };
+
+// 12 bytes: filhos são índices de 32 bits e identificadores são ids internados
+typedef struct {
+    uint8_t type;
+    char operator;
+    union {
+        int32_t number;
+        uint32_t name;
+        struct {
+            NodeId left_child, right_child;
+        };
+    };
+} Node;
+
+// Arena de uma análise: nós, tabela de nomes e tabela de hash-consing.
+// expr_arena_reset reaproveita os buffers; expr_arena_free libera tudo de uma vez.
+typedef struct {
+    Node* nodes;
+    uint32_t node_count;
+    uint32_t node_capacity;
+
+    NodeId* node_slots;
+    uint32_t node_slot_count;
+
+    char* names;
+    uint32_t names_size;
+    uint32_t names_capacity;
+
+    uint32_t* name_slots;
+    uint32_t name_slot_count;
+    uint32_t name_count;
+} ExprArena;
+
+typedef struct {
+    const char* source;
+    int index;
+    char current_char;
+    int current_num;
+    uint32_t current_identifier;
+    ExprArena* arena;
+} ExprParser;
+
+void expr_arena_init(ExprArena* arena);
+void expr_arena_reset(ExprArena* arena);
+void expr_arena_free(ExprArena* arena);
+
+uint32_t expr_intern_name(ExprArena* arena, const char* name, size_t length);
+const char* expr_name(const ExprArena* arena, uint32_t name);
+
+static inline const Node* expr_node(const ExprArena* arena, NodeId id) {
+    return &arena->nodes[id];
+}
+
+NodeId expr_make_number(ExprArena* arena, int number);
+NodeId expr_make_variable(ExprArena* arena, uint32_t name);
+NodeId expr_make_op(ExprArena* arena, char operator, NodeId left, NodeId right);
+
+void expr_parser_init(ExprParser* parser, ExprArena* arena, const char* source);
+void expr_advance_parser(ExprParser* parser);
+NodeId expr_parse_assignment(ExprParser* parser);
+NodeId expr_parse_expression(ExprParser* parser);
+NodeId expr_parse_term(ExprParser* parser);
+NodeId expr_parse_factor(ExprParser* parser);
+
+#endif // EXPR_H